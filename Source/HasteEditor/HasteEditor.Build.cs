@@ -52,6 +52,7 @@ namespace UnrealBuildTool.Rules
                     "InputCore",
                     "SlateCore",
 				    "RenderCore",
+                    "Landscape",
                     "PropertyEditor",
                     "WorkspaceMenuStructure",
                     "LevelEditor",
@@ -0,0 +1,62 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HastePlacementFilter.h"
+
+bool UHastePlacementFilter::ShouldPlace_Implementation(const FHitResult& Hit)
+{
+	return true;
+}
+
+void UHastePlacementFilter::FilterCandidates(TArray<FHastePlacementCandidate>& Candidates)
+{
+	Candidates.RemoveAll([this](const FHastePlacementCandidate& Candidate) {
+		return !ShouldPlace(Candidate.Hit);
+	});
+}
+
+bool UHastePlacementFilter::HashForSurface(const FHasteSurfaceStats& Stats, uint32& OutHash) const
+{
+	return false;
+}
+
+uint32 UHastePlacementFilter::HashRangeTest(float Lower, float Upper, float ObservedMin, float ObservedMax)
+{
+	// Moving a limit outside of the observed values does not change which of them pass
+	const float EffectiveLower = Lower > ObservedMax ? MAX_flt : FMath::Max(Lower, ObservedMin);
+	const float EffectiveUpper = Upper < ObservedMin ? -MAX_flt : FMath::Min(Upper, ObservedMax);
+	return HashCombine(GetTypeHash(EffectiveLower), GetTypeHash(EffectiveUpper));
+}
+
+bool UHastePlacementFilter::AreThreadSafe(const TArray<UHastePlacementFilter*>& Filters)
+{
+	for (const UHastePlacementFilter* Filter : Filters) {
+		if (Filter && !Filter->GetClass()->HasAnyClassFlags(CLASS_Native)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void UHastePlacementFilter::ApplyFilters(const TArray<UHastePlacementFilter*>& Filters, TArray<FHastePlacementCandidate>& Candidates)
+{
+	// Filters are independent of each other, so the cheap native batches can run before the blueprint ones
+	for (int32 Pass = 0; Pass < 2; Pass++) {
+		const bool bNativePass = (Pass == 0);
+		for (UHastePlacementFilter* Filter : Filters) {
+			if (Candidates.Num() == 0) {
+				return;
+			}
+			if (!Filter || Filter->GetClass()->HasAnyClassFlags(CLASS_Native) != bNativePass) {
+				continue;
+			}
+
+			// A blueprint subclass of a native filter inherits its native batch, which would skip the blueprint override
+			if (bNativePass) {
+				Filter->FilterCandidates(Candidates);
+			}
+			else {
+				Filter->UHastePlacementFilter::FilterCandidates(Candidates);
+			}
+		}
+	}
+}
@@ -0,0 +1,43 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "Placement/HastePlacement.h"
+#include "HastePlacementFilter.generated.h"
+
+/**
+ * Rule that decides if a mesh may be placed on a surface, based on the trace hit under the placement
+ */
+UCLASS(EditInlineNew, DefaultToInstanced, BlueprintType, Blueprintable, HideDropDown, abstract)
+class UHastePlacementFilter : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Return false to discard the placement */
+	UFUNCTION(BlueprintNativeEvent, Category = "Haste")
+	bool ShouldPlace(const FHitResult& Hit);
+	virtual bool ShouldPlace_Implementation(const FHitResult& Hit);
+
+	/**
+	 * Removes the rejected candidates from the list.
+	 * Native filters override this to process the whole batch without a per-candidate event dispatch, and must
+	 * reject exactly the candidates ShouldPlace rejects. Blueprint classes are always filtered through ShouldPlace
+	 */
+	virtual void FilterCandidates(TArray<FHastePlacementCandidate>& Candidates);
+
+	/**
+	 * Hashes the settings that can change the result of the filter on a surface with the given stats, so a scatter
+	 * cell is only regenerated by the edits that affect it. Returns false if the filter cannot narrow it down,
+	 * in which case all of its properties are hashed. Only used for native classes
+	 */
+	virtual bool HashForSurface(const FHasteSurfaceStats& Stats, uint32& OutHash) const;
+
+	/** Runs the filter stack over the candidates. Native filters run first, so blueprint filters only see the survivors */
+	static void ApplyFilters(const TArray<UHastePlacementFilter*>& Filters, TArray<FHastePlacementCandidate>& Candidates);
+
+	/** Returns true if the whole stack can be applied from a worker thread. Blueprint filters have to run on the game thread */
+	static bool AreThreadSafe(const TArray<UHastePlacementFilter*>& Filters);
+
+protected:
+	/** Hash of an inclusive range test, reduced to the part of the range that values within the observed range can tell apart */
+	static uint32 HashRangeTest(float Lower, float Upper, float ObservedMin, float ObservedMax);
+};
@@ -0,0 +1,31 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HastePlacementFilterHeight.h"
+
+UHastePlacementFilterHeight::UHastePlacementFilterHeight(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	MinHeight = -WORLD_MAX;
+	MaxHeight = WORLD_MAX;
+}
+
+bool UHastePlacementFilterHeight::ShouldPlace_Implementation(const FHitResult& Hit)
+{
+	return Hit.ImpactPoint.Z >= MinHeight && Hit.ImpactPoint.Z <= MaxHeight;
+}
+
+void UHastePlacementFilterHeight::FilterCandidates(TArray<FHastePlacementCandidate>& Candidates)
+{
+	const float Min = MinHeight;
+	const float Max = MaxHeight;
+	Candidates.RemoveAll([Min, Max](const FHastePlacementCandidate& Candidate) {
+		const float Height = Candidate.Hit.ImpactPoint.Z;
+		return Height < Min || Height > Max;
+	});
+}
+
+bool UHastePlacementFilterHeight::HashForSurface(const FHasteSurfaceStats& Stats, uint32& OutHash) const
+{
+	OutHash = HashRangeTest(MinHeight, MaxHeight, Stats.MinHeight, Stats.MaxHeight);
+	return true;
+}
@@ -0,0 +1,22 @@
+//$ Copyright 2015 Ali Akbar, Code Respawn Technologies Pvt Ltd - All Rights Reserved $//
+#pragma once
+#include "HastePlacementFilter.h"
+#include "HastePlacementFilterHeight.generated.h"
+
+/** Only places meshes on surfaces whose world height lies within a range */
+UCLASS(EditInlineNew, DefaultToInstanced, BlueprintType, Blueprintable)
+class UHastePlacementFilterHeight : public UHastePlacementFilter
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Haste)
+	float MinHeight;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Haste)
+	float MaxHeight;
+
+	virtual bool ShouldPlace_Implementation(const FHitResult& Hit) override;
+	virtual void FilterCandidates(TArray<FHastePlacementCandidate>& Candidates) override;
+	virtual bool HashForSurface(const FHasteSurfaceStats& Stats, uint32& OutHash) const override;
+};
@@ -0,0 +1,49 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HastePlacementFilterSlope.h"
+
+/** Keeps flat ground inside a zero minimum slope despite rounding of the normal */
+#define HASTE_SLOPE_TOLERANCE KINDA_SMALL_NUMBER
+
+UHastePlacementFilterSlope::UHastePlacementFilterSlope(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	MinSlope = 0;
+	MaxSlope = 45;
+}
+
+void UHastePlacementFilterSlope::GetNormalZRange(float& OutMinNormalZ, float& OutMaxNormalZ) const
+{
+	OutMaxNormalZ = FMath::Cos(FMath::DegreesToRadians(MinSlope));
+	OutMinNormalZ = FMath::Cos(FMath::DegreesToRadians(MaxSlope));
+}
+
+bool UHastePlacementFilterSlope::IsNormalInRange(const FVector& Normal, float MinNormalZ, float MaxNormalZ)
+{
+	return Normal.Z >= MinNormalZ - HASTE_SLOPE_TOLERANCE && Normal.Z <= MaxNormalZ + HASTE_SLOPE_TOLERANCE;
+}
+
+bool UHastePlacementFilterSlope::ShouldPlace_Implementation(const FHitResult& Hit)
+{
+	float MinNormalZ, MaxNormalZ;
+	GetNormalZRange(MinNormalZ, MaxNormalZ);
+	return IsNormalInRange(Hit.ImpactNormal, MinNormalZ, MaxNormalZ);
+}
+
+void UHastePlacementFilterSlope::FilterCandidates(TArray<FHastePlacementCandidate>& Candidates)
+{
+	// Compare the Z component of the normal against the cosine of the limits, instead of finding the angle of every hit
+	float MinNormalZ, MaxNormalZ;
+	GetNormalZRange(MinNormalZ, MaxNormalZ);
+	Candidates.RemoveAll([MinNormalZ, MaxNormalZ](const FHastePlacementCandidate& Candidate) {
+		return !IsNormalInRange(Candidate.Hit.ImpactNormal, MinNormalZ, MaxNormalZ);
+	});
+}
+
+bool UHastePlacementFilterSlope::HashForSurface(const FHasteSurfaceStats& Stats, uint32& OutHash) const
+{
+	float MinNormalZ, MaxNormalZ;
+	GetNormalZRange(MinNormalZ, MaxNormalZ);
+	OutHash = HashRangeTest(MinNormalZ - HASTE_SLOPE_TOLERANCE, MaxNormalZ + HASTE_SLOPE_TOLERANCE, Stats.MinNormalZ, Stats.MaxNormalZ);
+	return true;
+}
@@ -0,0 +1,29 @@
+//$ Copyright 2015 Ali Akbar, Code Respawn Technologies Pvt Ltd - All Rights Reserved $//
+#pragma once
+#include "HastePlacementFilter.h"
+#include "HastePlacementFilterSlope.generated.h"
+
+/** Only places meshes on surfaces whose slope lies within a range */
+UCLASS(EditInlineNew, DefaultToInstanced, BlueprintType, Blueprintable)
+class UHastePlacementFilterSlope : public UHastePlacementFilter
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	/** Minimum surface slope in degrees. Zero is flat ground */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Haste, meta = (ClampMin = "0", ClampMax = "180"))
+	float MinSlope;
+
+	/** Maximum surface slope in degrees */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Haste, meta = (ClampMin = "0", ClampMax = "180"))
+	float MaxSlope;
+
+	virtual bool ShouldPlace_Implementation(const FHitResult& Hit) override;
+	virtual void FilterCandidates(TArray<FHastePlacementCandidate>& Candidates) override;
+	virtual bool HashForSurface(const FHasteSurfaceStats& Stats, uint32& OutHash) const override;
+
+private:
+	/** Range of the Z component of the surface normal that lies within the slope limits */
+	void GetNormalZRange(float& OutMinNormalZ, float& OutMaxNormalZ) const;
+	static bool IsNormalInRange(const FVector& Normal, float MinNormalZ, float MaxNormalZ);
+};
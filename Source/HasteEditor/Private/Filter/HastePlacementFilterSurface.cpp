@@ -0,0 +1,51 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HastePlacementFilterSurface.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+UHastePlacementFilterSurface::UHastePlacementFilterSurface(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	bExclude = false;
+}
+
+bool UHastePlacementFilterSurface::MatchesSurface(const UPhysicalMaterial* PhysMaterial) const
+{
+	if (PhysicalMaterials.Contains(PhysMaterial)) {
+		return true;
+	}
+	const EPhysicalSurface SurfaceType = UPhysicalMaterial::DetermineSurfaceType(PhysMaterial);
+	return SurfaceTypes.Contains(SurfaceType);
+}
+
+bool UHastePlacementFilterSurface::ShouldPlace_Implementation(const FHitResult& Hit)
+{
+	return MatchesSurface(Hit.PhysMaterial.Get()) != bExclude;
+}
+
+void UHastePlacementFilterSurface::FilterCandidates(TArray<FHastePlacementCandidate>& Candidates)
+{
+	// Most candidates of a batch land on the same few materials, so remember the last answer
+	const UPhysicalMaterial* LastMaterial = nullptr;
+	bool bLastResult = false;
+	bool bHasLastResult = false;
+	Candidates.RemoveAll([&](const FHastePlacementCandidate& Candidate) {
+		const UPhysicalMaterial* PhysMaterial = Candidate.Hit.PhysMaterial.Get();
+		if (!bHasLastResult || PhysMaterial != LastMaterial) {
+			LastMaterial = PhysMaterial;
+			bLastResult = MatchesSurface(PhysMaterial) != bExclude;
+			bHasLastResult = true;
+		}
+		return !bLastResult;
+	});
+}
+
+bool UHastePlacementFilterSurface::HashForSurface(const FHasteSurfaceStats& Stats, uint32& OutHash) const
+{
+	// Only the answers for the materials under the cell matter
+	OutHash = 0;
+	for (const TWeakObjectPtr<UPhysicalMaterial>& PhysMaterial : Stats.PhysMaterials) {
+		OutHash = HashCombine(OutHash, (MatchesSurface(PhysMaterial.Get()) != bExclude) ? 1 : 0);
+	}
+	return true;
+}
@@ -0,0 +1,29 @@
+//$ Copyright 2015 Ali Akbar, Code Respawn Technologies Pvt Ltd - All Rights Reserved $//
+#pragma once
+#include "HastePlacementFilter.h"
+#include "HastePlacementFilterSurface.generated.h"
+
+/** Places meshes only on (or never on) surfaces with the listed physical materials or surface types */
+UCLASS(EditInlineNew, DefaultToInstanced, BlueprintType, Blueprintable)
+class UHastePlacementFilterSurface : public UHastePlacementFilter
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Haste)
+	TArray<UPhysicalMaterial*> PhysicalMaterials;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Haste)
+	TArray<TEnumAsByte<EPhysicalSurface>> SurfaceTypes;
+
+	/** Reject the listed surfaces instead of only accepting them */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Haste)
+	bool bExclude;
+
+	virtual bool ShouldPlace_Implementation(const FHitResult& Hit) override;
+	virtual void FilterCandidates(TArray<FHastePlacementCandidate>& Candidates) override;
+	virtual bool HashForSurface(const FHasteSurfaceStats& Stats, uint32& OutHash) const override;
+
+private:
+	bool MatchesSurface(const UPhysicalMaterial* PhysMaterial) const;
+};
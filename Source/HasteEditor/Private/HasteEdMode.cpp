@@ -19,6 +19,22 @@
 #include "ContentBrowserModule.h"
 #include "HasteEdModeToolkit.h"
 #include "HasteEdModeSettings.h"
+#include "HasteProjectSettings.h"
+#include "Placement/HasteCullDistance.h"
+#include "Placement/HasteDeferredInvalidation.h"
+#include "Placement/HasteInstanceContainer.h"
+#include "Placement/HasteScatterRecord.h"
+#include "Placement/HasteDuplicateScan.h"
+#include "Sampling/HasteBlueNoise.h"
+#include "Placement/HastePlacementJournal.h"
+#include "ParallelFor.h"
+#include "AI/Navigation/NavigationSystem.h"
+#include "Landscape.h"
+#include "LandscapeInfo.h"
+#include "Stamp/HasteStamp.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "SNotificationList.h"
+#include "NotificationManager.h"
 #include "Transformer/HasteTransformLogic.h"
 
 FEditorModeID FEdModeHaste::EM_Haste(TEXT("EM_Haste"));
@@ -29,7 +45,11 @@ FEditorModeID FEdModeHaste::EM_Haste(TEXT("EM_Haste"));
 
 DEFINE_LOG_CATEGORY(LogHasteMode);
 
-#define BRUSH_RADIUS 100
+#define MAX_PAINT_CANDIDATES_PER_TICK 10000
+#define DEFAULT_BRUSH_MESH_RADIUS 50.f
+
+/** A blue noise point is taken if a placement lies within this fraction of the sample spacing of it */
+#define HASTE_BLUE_NOISE_OCCUPIED_RADIUS 0.5f
 //
 // FEdModeHaste
 //
@@ -43,6 +63,12 @@ FEdModeHaste::FEdModeHaste()
 	, bCanAltDrag(false)
 	, bMeshRotating(false)
 	, RotationOffset(FVector::ZeroVector)
+	, PlacementSeed(0)
+	, bScatterUpdatePending(false)
+	, ScatterRuleRevision(0)
+	, DensityMaskKey(0)
+	, DefaultBlueNoiseTiles(nullptr)
+	, BlueNoiseSeed(FMath::Rand())
 	, UISettings(nullptr)
 {
 	// Load resources and construct brush component
@@ -53,6 +79,7 @@ FEdModeHaste::FEdModeHaste()
 		DefaultBrushMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/EngineMeshes/Sphere.Sphere"), nullptr, LOAD_None, nullptr);
 		ActiveBrushMesh = nullptr;
 	}
+	ActiveStamp = nullptr;
 
 	BrushMeshComponent = NewObject<UStaticMeshComponent>();
 	BrushMeshComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
@@ -63,10 +90,17 @@ FEdModeHaste::FEdModeHaste()
 	BrushMeshComponent->CastShadow = false;
 
 	bBrushTraceValid = false;
+	bBrushPlacementBlocked = false;
+	bRealtimeForced = false;
+	bViewportRedrawRequested = false;
+	LastViewLocation = FVector::ZeroVector;
+	LastViewRotation = FRotator::ZeroRotator;
 	BrushLocation = FVector::ZeroVector;
 	BrushScale = FVector(1);
 	BrushRotation = FQuat::Identity;
 	LastMousePosition = FIntVector::ZeroValue;
+	HoveredViewportClient = nullptr;
+	LastBrushTraceFrame = 0;
 
 	ResetBrushMesh();
 }
@@ -77,6 +111,10 @@ FEdModeHaste::~FEdModeHaste()
 {
 	// Save UI settings to config file
 	FEditorDelegates::MapChange.RemoveAll(this);
+
+	// Finish a running job while the state its callbacks write to is intact
+	PlacementPipeline.Cancel();
+	CancelScatterCheck();
 }
 
 
@@ -88,6 +126,10 @@ void FEdModeHaste::AddReferencedObjects(FReferenceCollector& Collector)
 
 	Collector.AddReferencedObject(BrushMeshComponent);
 	Collector.AddReferencedObject(UISettings);
+	Collector.AddReferencedObjects(SelectedBrushMeshes);
+	Collector.AddReferencedObjects(SelectedStamps);
+	ScatterRecords.AddReferencedObjects(Collector);
+	Collector.AddReferencedObject(DefaultBlueNoiseTiles);
 }
 
 /** FEdMode: Called when the mode is entered */
@@ -104,12 +146,24 @@ void FEdModeHaste::Enter()
 
 	// Bind to editor callbacks
 	FEditorDelegates::NewCurrentLevel.AddSP(this, &FEdModeHaste::NotifyNewCurrentLevel);
-
-	// Force real-time viewports.  We'll back up the current viewport state so we can restore it when the
-	// user exits this mode.
-	const bool bWantRealTime = true;
-	const bool bRememberCurrentState = true;
-	ForceRealTimeViewports(bWantRealTime, bRememberCurrentState);
+	FEditorDelegates::MapChange.AddRaw(this, &FEdModeHaste::OnMapChange);
+	FWorldDelegates::OnWorldCleanup.AddRaw(this, &FEdModeHaste::OnWorldCleanup);
+	LevelActorDeletedDelegate = GEngine->OnLevelActorDeleted().AddRaw(this, &FEdModeHaste::OnHastePlacementDeleted);
+	ActorMovedDelegate = GEngine->OnActorMoved().AddRaw(this, &FEdModeHaste::OnHastePlacementMoved);
+	ObjectPropertyChangedDelegate = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FEdModeHaste::OnObjectPropertyChanged);
+	MeshInvalidatedDelegate = FHasteMeshMetadataCache::Get().OnMeshInvalidated().AddRaw(this, &FEdModeHaste::OnMeshMetadataInvalidated);
+
+	// Placements may have been added or removed (or the landscape edited, or meshes reimported) while we were in another mode.
+	// Setting the metadata cache drops the bounds cached by the overlap filter
+	OverlapFilter.SetMetadataCache(&FHasteMeshMetadataCache::Get());
+	OverlapFilter.MarkDirty();
+	LandscapeCache.Reset();
+	DensityMask.Reset();
+
+	// Force real-time viewports, unless the viewports are redrawn on demand.  The current viewport state
+	// is backed up so we can restore it when the user exits this mode.
+	bRealtimeForced = false;
+	UpdateRealtimeViewports();
 
 
 	if (!Toolkit.IsValid())
@@ -138,16 +192,37 @@ void FEdModeHaste::Exit()
 		Toolkit.Reset();
 	}
 
+	// Keep what a bulk placement has committed so far, and finish any paint stroke that is still in progress
+	PlacementPipeline.Cancel();
+	CancelScatterCheck();
+	if (bToolActive) {
+		bToolActive = false;
+		EndStroke();
+	}
+
 	//
 	FEditorDelegates::NewCurrentLevel.RemoveAll(this);
+	FEditorDelegates::MapChange.RemoveAll(this);
+	FWorldDelegates::OnWorldCleanup.RemoveAll(this);
+	GEngine->OnLevelActorDeleted().Remove(LevelActorDeletedDelegate);
+	GEngine->OnActorMoved().Remove(ActorMovedDelegate);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedDelegate);
+	FHasteMeshMetadataCache::Get().OnMeshInvalidated().Remove(MeshInvalidatedDelegate);
+
+	// No background build may still be reading a mesh once the mode is gone, e.g. while it is reimported
+	FHasteMeshMetadataCache::Get().Flush();
 
 	// Remove the brush
 	BrushMeshComponent->UnregisterComponent();
+	InvalidateViewports();
 
 	// Restore real-time viewport state if we changed it
-	const bool bWantRealTime = false;
-	const bool bRememberCurrentState = false;
-	ForceRealTimeViewports(bWantRealTime, bRememberCurrentState);
+	if (bRealtimeForced) {
+		const bool bWantRealTime = false;
+		const bool bRememberCurrentState = false;
+		ForceRealTimeViewports(bWantRealTime, bRememberCurrentState);
+		bRealtimeForced = false;
+	}
 
 	// Unregister from the content browser
 	{
@@ -164,6 +239,7 @@ void FEdModeHaste::OnContentBrowserSelectionChanged(const TArray<FAssetData>& Ne
 	UE_LOG(LogHasteMode, Log, TEXT("Content Browser Selection Changed"));
 
 	SelectedBrushMeshes.Reset();
+	SelectedStamps.Reset();
 
 	// Select the first static mesh we find from the list of selected assets
 	for (const FAssetData& Asset : NewSelectedAssets) {
@@ -171,7 +247,20 @@ void FEdModeHaste::OnContentBrowserSelectionChanged(const TArray<FAssetData>& Ne
 		if (UStaticMesh* StaticMesh = Cast<UStaticMesh>(AssetObj)) {
 			SelectedBrushMeshes.Add(StaticMesh);
 		}
+		else if (UHasteStamp* Stamp = Cast<UHasteStamp>(AssetObj)) {
+			SelectedStamps.Add(Stamp);
+		}
+	}
+
+	// Read the placement data of the palette in the background, before the first placement needs it
+	TArray<UStaticMesh*> PaletteMeshes = SelectedBrushMeshes;
+	for (UHasteStamp* Stamp : SelectedStamps) {
+		for (const FHasteStampMeshGroup& Group : Stamp->GetMeshGroups()) {
+			PaletteMeshes.AddUnique(Group.Mesh);
+		}
 	}
+	FHasteMeshMetadataCache::Get().Request(PaletteMeshes);
+
 	RotationOffset = FVector::ZeroVector;
 	ResetBrushMesh();
 }
@@ -187,12 +276,24 @@ void FEdModeHaste::ResetBrushMesh()
 	}
 	BrushMeshComponent->SetStaticMesh(RandomMesh ? RandomMesh : DefaultBrushMesh);
 	ActiveBrushMesh = RandomMesh;
+
+	ActiveStamp = SelectedStamps.Num() > 0 ? SelectedStamps[FMath::RandRange(0, SelectedStamps.Num() - 1)] : nullptr;
+	PlacementSeed = FMath::Rand();
+	bViewportRedrawRequested = true;
 }
 
 void FEdModeHaste::PostUndo()
 {
 	FEdMode::PostUndo();
 
+	// The containers a running job adds to may have been restored to their state before the job
+	PlacementPipeline.Cancel();
+	RestoreScatterRecords();
+
+	OverlapFilter.MarkDirty();
+	LandscapeCache.Reset();
+	DensityMask.Reset();
+
 	//StaticCastSharedPtr<FHasteEdModeToolkit>(Toolkit)->RefreshFullList();
 }
 
@@ -202,6 +303,161 @@ void FEdModeHaste::NotifyNewCurrentLevel()
 
 }
 
+void FEdModeHaste::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	// MapChange is broadcast once the old world is gone, so the job and the stroke are ended while their world still exists
+	if (World && World == GetWorld()) {
+		PlacementPipeline.Cancel();
+		CancelScatterCheck();
+		if (bToolActive) {
+			bToolActive = false;
+			EndStroke();
+		}
+	}
+}
+
+void FEdModeHaste::OnMapChange(uint32 MapChangeFlags)
+{
+	PlacementPipeline.Cancel();
+	CancelScatterCheck();
+	ScatterRecords.Reset();
+	bScatterUpdatePending = false;
+	OverlapFilter.MarkDirty();
+	LandscapeCache.Reset();
+	DensityMask.Reset();
+}
+
+/** Returns true if the setting is one of the rules the scattered cells are generated from */
+static bool IsScatterRuleProperty(FName PropertyName)
+{
+	static const FName RuleProperties[] = {
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, Transformers),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, Filters),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, PaintDensity),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, SampleMode),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, BlueNoiseTiles),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, bRejectOverlaps),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, OverlapShape),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, OverlapBoundsScale),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, DensityMaskTexture),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, DensityMaskChannel),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, DensityMaskOrigin),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, DensityMaskSize),
+		GET_MEMBER_NAME_CHECKED(UHasteEdModeSettings, DensityMaskLayer),
+	};
+	for (const FName& RuleProperty : RuleProperties) {
+		if (PropertyName == RuleProperty) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void FEdModeHaste::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// Wait until a slider is released before regenerating
+	if (!UISettings || PropertyChangedEvent.ChangeType == EPropertyChangeType::Interactive) {
+		return;
+	}
+	if (!Object || (Object != UISettings && !Object->IsIn(UISettings))) {
+		return;
+	}
+
+	// Any edit of a filter or transformer counts, but most of the settings do not change what a scatter generates
+	const UProperty* Property = PropertyChangedEvent.MemberProperty ? PropertyChangedEvent.MemberProperty : PropertyChangedEvent.Property;
+	if (Object == UISettings && Property && !IsScatterRuleProperty(Property->GetFName())) {
+		return;
+	}
+
+	ScatterRuleRevision++;
+	if (UISettings->bUpdateScatterOnChange) {
+		bScatterUpdatePending = true;
+	}
+}
+
+void FEdModeHaste::OnMeshMetadataInvalidated(UStaticMesh* Mesh)
+{
+	OverlapFilter.InvalidateMesh(Mesh);
+	if (SelectedBrushMeshes.Contains(Mesh)) {
+		FHasteMeshMetadataCache::Get().Request(TArray<UStaticMesh*>({ Mesh }));
+	}
+}
+
+void FEdModeHaste::OnHastePlacementMoved(AActor* Actor)
+{
+	if (Actor && Actor->ActorHasTag(FHasteTags::PlacedActor)) {
+		OverlapFilter.UpdateActor(Actor);
+	}
+}
+
+void FEdModeHaste::OnHastePlacementDeleted(AActor* Actor)
+{
+	if (Actor && Actor->ActorHasTag(FHasteTags::PlacedActor)) {
+		OverlapFilter.RemoveActor(Actor);
+	}
+}
+
+void FEdModeHaste::UpdateOverlapFilter()
+{
+	OverlapFilter.SetShape(UISettings->OverlapShape, UISettings->OverlapBoundsScale);
+	OverlapFilter.Update(GetWorld());
+}
+
+TSharedPtr<const FHasteDensityMask, ESPMode::ThreadSafe> FEdModeHaste::UpdateDensityMask()
+{
+	UTexture2D* Texture = UISettings->DensityMaskTexture;
+	ULandscapeLayerInfoObject* Layer = Texture ? nullptr : UISettings->DensityMaskLayer;
+	if (!Texture && !Layer) {
+		DensityMask.Reset();
+		return DensityMask;
+	}
+
+	// Decode once, and again only when the mask settings change or the texture is reimported
+	uint32 Key = HashCombine(GetTypeHash(Texture), GetTypeHash(Layer));
+	if (Texture) {
+		Key = HashCombine(Key, GetTypeHash(Texture->Source.GetId()));
+		Key = HashCombine(Key, GetTypeHash(uint8(UISettings->DensityMaskChannel)));
+		Key = HashCombine(Key, HashCombine(GetTypeHash(UISettings->DensityMaskOrigin), GetTypeHash(UISettings->DensityMaskSize)));
+	}
+	if (!DensityMask.IsValid() || Key != DensityMaskKey) {
+		DensityMask = BuildDensityMask(Texture, Layer);
+		DensityMaskKey = Key;
+	}
+
+	// A mask that failed to decode is kept as well, so it is not decoded again every frame
+	return DensityMask->IsValid() ? DensityMask : nullptr;
+}
+
+TSharedRef<const FHasteDensityMask, ESPMode::ThreadSafe> FEdModeHaste::BuildDensityMask(UTexture2D* Texture, ULandscapeLayerInfoObject* Layer)
+{
+	TSharedRef<FHasteDensityMask, ESPMode::ThreadSafe> Mask = MakeShareable(new FHasteDensityMask);
+	bool bBuilt = false;
+	if (Texture) {
+		const FBox2D WorldBounds(UISettings->DensityMaskOrigin, UISettings->DensityMaskOrigin + UISettings->DensityMaskSize);
+		bBuilt = Mask->BuildFromTexture(Texture, int32(UISettings->DensityMaskChannel), WorldBounds);
+	}
+	else {
+		for (TActorIterator<ALandscapeProxy> It(GetWorld()); It && !bBuilt; ++It) {
+			ULandscapeInfo* Info = It->GetLandscapeInfo();
+			if (Info && Info->GetLayerInfoIndex(Layer) != INDEX_NONE) {
+				bBuilt = Mask->BuildFromLandscapeLayer(Info, Layer);
+			}
+		}
+	}
+
+	return Mask;
+}
+
+bool FEdModeHaste::IsPaintMode() const
+{
+	return UISettings && UISettings->PlacementMode == EHastePlacementMode::Paint;
+}
+
+bool FEdModeHaste::IsStampMode() const
+{
+	return UISettings && UISettings->PlacementMode == EHastePlacementMode::Stamp;
+}
+
 /** When the user changes the current tool in the UI */
 void FEdModeHaste::NotifyToolChanged()
 {
@@ -217,21 +473,67 @@ bool FEdModeHaste::DisallowMouseDeltaTracking() const
 /** FEdMode: Called once per frame */
 void FEdModeHaste::Tick(FEditorViewportClient* ViewportClient, float DeltaTime)
 {
-	if (bToolActive)
+	FEdMode::Tick(ViewportClient, DeltaTime);
+
+	UpdateRealtimeViewports();
+
+	// Catches a redo that did not go through PostUndo
+	RestoreScatterRecords();
+
+	if (ScatterCheck.IsValid() && ScatterCheck.IsReady())
+	{
+		FinishScatterCheck();
+	}
+	if (bScatterUpdatePending && !PlacementPipeline.IsRunning())
 	{
-		//ApplyBrush(ViewportClient);
+		UpdateScatter();
 	}
 
-	FEdMode::Tick(ViewportClient, DeltaTime);
+	// Show the placements of a bulk operation as they stream in
+	if (PlacementPipeline.IsRunning() && !bRealtimeForced)
+	{
+		InvalidateViewports();
+	}
+
+	// Tick is called for every level viewport. Only the viewport under the mouse traces the brush,
+	// once per frame, and the other viewports reuse its result
+	if (ViewportClient == HoveredViewportClient && LastBrushTraceFrame != GFrameCounter)
+	{
+		LastBrushTraceFrame = GFrameCounter;
 
-	// Trace the brush
-	HasteBrushTrace(ViewportClient, LastMousePosition.X, LastMousePosition.Y);
+		UpdateOverlapFilter();
+
+		if (bToolActive)
+		{
+			ApplyBrush(ViewportClient);
+		}
+
+		// Trace the brush
+		const FTransform PreviousCursorTransform = BrushCursorTransform;
+		const bool bPreviousTraceValid = bBrushTraceValid;
+		HasteBrushTrace(ViewportClient, LastMousePosition.X, LastMousePosition.Y);
+
+		// Without real-time viewports, redraw only when something the user can see has changed
+		const FVector ViewLocation = ViewportClient->GetViewLocation();
+		const FRotator ViewRotation = ViewportClient->GetViewRotation();
+		const bool bCameraMoved = !ViewLocation.Equals(LastViewLocation) || !ViewRotation.Equals(LastViewRotation);
+		LastViewLocation = ViewLocation;
+		LastViewRotation = ViewRotation;
+
+		const bool bCursorMoved = bBrushTraceValid != bPreviousTraceValid || !BrushCursorTransform.Equals(PreviousCursorTransform);
+		if (!bRealtimeForced && (bViewportRedrawRequested || bToolActive || bCameraMoved || bCursorMoved))
+		{
+			InvalidateViewports();
+		}
+		bViewportRedrawRequested = false;
+	}
 
 
 	// Update the position and size of the brush component
 	if (bBrushTraceValid)
 	{
 		// Scale adjustment is due to default sphere SM size.
+		BrushMeshComponent->SetStaticMesh((!IsPaintMode() && !IsStampMode() && ActiveBrushMesh) ? ActiveBrushMesh : DefaultBrushMesh);
 		BrushMeshComponent->SetRelativeTransform(BrushCursorTransform);
 
 		if (!BrushMeshComponent->IsRegistered())
@@ -248,10 +550,12 @@ void FEdModeHaste::Tick(FEditorViewportClient* ViewportClient, float DeltaTime)
 	}
 }
 
-static bool HasteTrace(UWorld* InWorld, FHitResult& OutHit, FVector InStart, FVector InEnd, FName InTraceTag, bool InbReturnFaceIndex = false)
+static bool HasteTrace(UWorld* InWorld, FHitResult& OutHit, FVector InStart, FVector InEnd, FName InTraceTag, bool InbReturnFaceIndex = false, const TArray<AActor*>& InIgnoredActors = TArray<AActor*>())
 {
 	FCollisionQueryParams QueryParams(InTraceTag, true);
 	QueryParams.bReturnFaceIndex = InbReturnFaceIndex;
+	QueryParams.bReturnPhysicalMaterial = true;
+	QueryParams.AddIgnoredActors(InIgnoredActors);
 
 	bool bResult = true;
 	while (true)
@@ -277,6 +581,34 @@ static bool HasteTrace(UWorld* InWorld, FHitResult& OutHit, FVector InStart, FVe
 	return bResult;
 }
 
+/** Number of height probes along each side of a scatter cell, used to detect edits to the surface under it */
+#define HASTE_SURFACE_PROBES 8
+
+/** Coarse signature of the surface under the bounds. Changes when the surface is edited or something is placed on it */
+static uint32 HashScatterSurface(UWorld* InWorld, const FBox& Bounds, const TArray<AActor*>& IgnoredActors)
+{
+	static FName NAME_HasteSurfaceProbe = FName(TEXT("HasteSurfaceProbe"));
+	uint32 Hash = 0;
+	for (int32 Y = 0; Y < HASTE_SURFACE_PROBES; Y++) {
+		for (int32 X = 0; X < HASTE_SURFACE_PROBES; X++) {
+			const float ProbeX = FMath::Lerp(Bounds.Min.X, Bounds.Max.X, (X + 0.5f) / HASTE_SURFACE_PROBES);
+			const float ProbeY = FMath::Lerp(Bounds.Min.Y, Bounds.Max.Y, (Y + 0.5f) / HASTE_SURFACE_PROBES);
+			FHitResult Hit;
+			const bool bHit = HasteTrace(InWorld, Hit, FVector(ProbeX, ProbeY, Bounds.Max.Z), FVector(ProbeX, ProbeY, Bounds.Min.Z), NAME_HasteSurfaceProbe, false, IgnoredActors);
+			Hash = HashCombine(Hash, bHit ? uint32(FMath::RoundToInt(Hit.Location.Z)) : MAX_uint32);
+		}
+	}
+	return Hash;
+}
+
+bool FEdModeHaste::ProjectToSurface(UWorld* World, const FVector& Start, const FVector& End, FHitResult& OutHit, FName TraceTag)
+{
+	if (LandscapeCache.Trace(Start, End, OutHit)) {
+		return true;
+	}
+	return HasteTrace(World, OutHit, Start, End, TraceTag);
+}
+
 FVector PerformLocationSnap(const FVector& Location) {
 	//ULevelEditorViewportSettings* ViewportSettings = GetMutableDefault<ULevelEditorViewportSettings>();
 	//int32 SnapWidth = ViewportSettings->GridEnabled;
@@ -318,8 +650,10 @@ void FEdModeHaste::HasteBrushTrace(FEditorViewportClient* ViewportClient, int32
 		static FName NAME_HasteBrush = FName(TEXT("HasteBrush"));
 		if (HasteTrace(World, Hit, Start, End, NAME_HasteBrush))
 		{
+			BrushHit = Hit;
+
 			// Adjust the sphere brush
-			BrushLocation = PerformLocationSnap(Hit.Location);
+			BrushLocation = IsPaintMode() ? Hit.Location : PerformLocationSnap(Hit.Location);
 
 			// Find the rotation based on the normal
 			LastHitImpact = Hit.ImpactNormal;
@@ -329,9 +663,51 @@ void FEdModeHaste::HasteBrushTrace(FEditorViewportClient* ViewportClient, int32
 		}
 	}
 
+	bBrushPlacementBlocked = false;
 	if (bBrushTraceValid) {
-		BrushCursorTransform = FTransform(BrushRotation, BrushLocation, BrushScale);
-		BrushCursorTransform = ApplyTransformers(BrushCursorTransform);
+		if (IsPaintMode()) {
+			const float BrushMeshScale = UISettings->PaintBrushRadius / DEFAULT_BRUSH_MESH_RADIUS;
+			BrushCursorTransform = FTransform(FQuat::Identity, BrushLocation, FVector(BrushMeshScale));
+		}
+		else if (IsStampMode()) {
+			// The filters only look at the surface under the stamp root. Stamps are authored to interpenetrate, so they skip the overlap test
+			TArray<FHastePlacementCandidate> Candidates;
+			Candidates.AddDefaulted(1);
+			Candidates[0].Transform = FTransform(BrushRotation, BrushLocation, BrushScale);
+			Candidates[0].Hit = BrushHit;
+			UHastePlacementFilter::ApplyFilters(UISettings->Filters, Candidates);
+			bBrushPlacementBlocked = Candidates.Num() == 0;
+
+			StampRootTransform = FTransform(BrushRotation, BrushLocation, BrushScale);
+			if (!bBrushPlacementBlocked) {
+				StampRootTransform = ApplyTransformers(StampRootTransform, PlacementSeed);
+			}
+
+			// Show the bounding sphere of the stamp
+			const FBoxSphereBounds StampBounds = ActiveStamp ? ActiveStamp->GetBounds() : FBoxSphereBounds(FVector::ZeroVector, FVector(DEFAULT_BRUSH_MESH_RADIUS), DEFAULT_BRUSH_MESH_RADIUS);
+			const float BrushMeshScale = StampBounds.SphereRadius * StampRootTransform.GetMaximumAxisScale() / DEFAULT_BRUSH_MESH_RADIUS;
+			BrushCursorTransform = FTransform(FQuat::Identity, StampRootTransform.TransformPosition(StampBounds.Origin), FVector(BrushMeshScale));
+		}
+		else {
+			BrushCursorTransform = FTransform(BrushRotation, BrushLocation, BrushScale);
+
+			// Reject filtered and overlapping placements before doing any transformer work
+			if (ActiveBrushMesh) {
+				TArray<FHastePlacementCandidate> Candidates;
+				Candidates.AddDefaulted(1);
+				Candidates[0].Mesh = ActiveBrushMesh;
+				Candidates[0].Transform = BrushCursorTransform;
+				Candidates[0].Hit = BrushHit;
+				UHastePlacementFilter::ApplyFilters(UISettings->Filters, Candidates);
+
+				bBrushPlacementBlocked = Candidates.Num() == 0
+					|| (UISettings->bRejectOverlaps && OverlapFilter.IsOverlapping(Candidates[0]));
+			}
+
+			if (!bBrushPlacementBlocked) {
+				BrushCursorTransform = ApplyTransformers(BrushCursorTransform, PlacementSeed);
+			}
+		}
 	}
 }
 
@@ -339,9 +715,14 @@ float SnapRotation(float Value, float SnapWidth) {
 	return FMath::RoundToInt(Value / SnapWidth) * SnapWidth;
 }
 
+FQuat FEdModeHaste::GetSurfaceRotation(const FVector& SurfaceNormal) const
+{
+	return FQuat::FindBetween(FVector(0, 0, 1), SurfaceNormal);
+}
+
 void FEdModeHaste::UpdateBrushRotation()
 {
-	BrushRotation = FQuat::FindBetween(FVector(0, 0, 1), LastHitImpact);
+	BrushRotation = GetSurfaceRotation(LastHitImpact);
 
 	// Append the brush rotation
 	if (UISettings->bRotateOnScroll) {
@@ -366,6 +747,8 @@ void FEdModeHaste::UpdateBrushRotation()
  */
 bool FEdModeHaste::MouseMove(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 MouseX, int32 MouseY)
 {
+	HoveredViewportClient = ViewportClient;
+
 	FIntVector CurrentMousePosition(MouseX, MouseY, 0);
 	if (LastMousePosition != CurrentMousePosition) {
 		//UE_LOG(LogHasteMode, Log, TEXT("MouseMove (%d, %d)"), MouseX, MouseY);
@@ -389,6 +772,8 @@ bool FEdModeHaste::MouseMove(FEditorViewportClient* ViewportClient, FViewport* V
  */
 bool FEdModeHaste::CapturedMouseMove(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 MouseX, int32 MouseY)
 {
+	HoveredViewportClient = ViewportClient;
+
 	FIntVector CurrentMousePosition(MouseX, MouseY, 0);
 	if (LastMousePosition != CurrentMousePosition && !bMeshRotating) {
 		//UE_LOG(LogHasteMode, Log, TEXT("CapturedMouseMove (%d, %d)"), MouseX, MouseY);
@@ -400,6 +785,24 @@ bool FEdModeHaste::CapturedMouseMove(FEditorViewportClient* ViewportClient, FVie
 	return false;
 }
 
+bool FEdModeHaste::MouseEnter(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 MouseX, int32 MouseY)
+{
+	HoveredViewportClient = ViewportClient;
+	LastMousePosition = FIntVector(MouseX, MouseY, 0);
+	return FEdMode::MouseEnter(ViewportClient, Viewport, MouseX, MouseY);
+}
+
+bool FEdModeHaste::MouseLeave(FEditorViewportClient* ViewportClient, FViewport* Viewport)
+{
+	if (HoveredViewportClient == ViewportClient) {
+		// Hide the brush until the mouse is over a viewport again
+		HoveredViewportClient = nullptr;
+		bBrushTraceValid = false;
+		InvalidateViewports();
+	}
+	return FEdMode::MouseLeave(ViewportClient, Viewport);
+}
+
 void FEdModeHaste::GetRandomVectorInBrush(FVector& OutStart, FVector& OutEnd)
 {
 	// Find Rx and Ry inside the unit circle
@@ -414,22 +817,155 @@ void FEdModeHaste::GetRandomVectorInBrush(FVector& OutStart, FVector& OutEnd)
 	// find distance to surface of sphere brush from this point
 	float Rw = FMath::Sqrt(1.f - (FMath::Square(Ru) + FMath::Square(Rv)));
 
-	OutStart = BrushLocation + BRUSH_RADIUS * (Ru * U + Rv * V - Rw * BrushTraceDirection);
-	OutEnd = BrushLocation + BRUSH_RADIUS * (Ru * U + Rv * V + Rw * BrushTraceDirection);
+	const float BrushRadius = UISettings->PaintBrushRadius;
+	OutStart = BrushLocation + BrushRadius * (Ru * U + Rv * V - Rw * BrushTraceDirection);
+	OutEnd = BrushLocation + BrushRadius * (Ru * U + Rv * V + Rw * BrushTraceDirection);
+}
+
+void FEdModeHaste::GetBlueNoiseVectorsInBrush(UHasteBlueNoiseTiles* Tiles, TArray<FVector>& OutStarts, TArray<FVector>& OutEnds)
+{
+	const float BrushRadius = UISettings->PaintBrushRadius;
+	const FVector2D Center(BrushLocation);
+	TArray<FVector2D> Points;
+	Tiles->GetPoints(FBox2D(Center - FVector2D(BrushRadius, BrushRadius), Center + FVector2D(BrushRadius, BrushRadius)),
+		Tiles->GetTileSize(UISettings->PaintDensity), BlueNoiseSeed, Points);
+
+	for (const FVector2D& Point : Points) {
+		const float DistanceSq = FVector2D::DistSquared(Point, Center);
+		if (DistanceSq < FMath::Square(BrushRadius)) {
+			const float HalfChord = FMath::Sqrt(FMath::Square(BrushRadius) - DistanceSq);
+			OutStarts.Add(FVector(Point, BrushLocation.Z + HalfChord));
+			OutEnds.Add(FVector(Point, BrushLocation.Z - HalfChord));
+		}
+	}
+}
+
+UHasteBlueNoiseTiles* FEdModeHaste::GetBlueNoiseTiles()
+{
+	if (UISettings->SampleMode != EHasteSampleMode::BlueNoise) {
+		return nullptr;
+	}
+	if (UISettings->BlueNoiseTiles && UISettings->BlueNoiseTiles->Points.Num() > 0) {
+		return UISettings->BlueNoiseTiles;
+	}
+	if (!DefaultBlueNoiseTiles) {
+		DefaultBlueNoiseTiles = NewObject<UHasteBlueNoiseTiles>(GetTransientPackage());
+		DefaultBlueNoiseTiles->Generate();
+	}
+	return DefaultBlueNoiseTiles;
 }
 
 void FEdModeHaste::ApplyBrush(FEditorViewportClient* ViewportClient)
 {
-	if (!bBrushTraceValid)
+	if (!bBrushTraceValid || SelectedBrushMeshes.Num() == 0)
+	{
+		return;
+	}
+
+	// Only top up the brush area to the desired density, so holding the brush in place does not pile up meshes
+	const float BrushRadius = UISettings->PaintBrushRadius;
+	const float BrushArea = PI * FMath::Square(BrushRadius);
+	const int32 DesiredCount = FMath::RoundToInt(UISettings->PaintDensity * BrushArea / (1000.f * 1000.f));
+	const int32 ExistingCount = OverlapFilter.CountInSphere(BrushLocation, BrushRadius);
+	const int32 NumCandidates = FMath::Min(DesiredCount - ExistingCount, MAX_PAINT_CANDIDATES_PER_TICK);
+	if (NumCandidates <= 0)
 	{
 		return;
 	}
+
+	UWorld* World = ViewportClient->GetWorld();
+	static FName NAME_HastePaint = FName(TEXT("HastePaint"));
+
+	// When painting on a landscape, project the candidates on to a cached copy of its heights
+	const FBox BrushBounds(BrushLocation - FVector(BrushRadius), BrushLocation + FVector(BrushRadius));
+	LandscapeCache.CacheRegion(World, BrushHit, BrushBounds);
+
+	// The mask is read at the mip whose texels are about as large as the spacing between the desired meshes
+	TSharedPtr<const FHasteDensityMask, ESPMode::ThreadSafe> Mask = UpdateDensityMask();
+	const float SampleFootprint = FMath::Sqrt(BrushArea / FMath::Max(DesiredCount, 1));
+
+	// Blue noise points are fixed in the world, so the brush tops up the gaps between earlier placements.
+	// The points are visited in random order, so a partial top up is spread over the whole brush.
+	// Points that already hold a placement are skipped, so repeated strokes do not stack meshes on them
+	TArray<FVector> BlueNoiseStarts, BlueNoiseEnds;
+	UHasteBlueNoiseTiles* BlueNoiseTiles = GetBlueNoiseTiles();
+	if (BlueNoiseTiles) {
+		GetBlueNoiseVectorsInBrush(BlueNoiseTiles, BlueNoiseStarts, BlueNoiseEnds);
+		for (int32 i = BlueNoiseStarts.Num() - 1; i > 0; i--) {
+			const int32 SwapIndex = FMath::RandRange(0, i);
+			BlueNoiseStarts.Swap(i, SwapIndex);
+			BlueNoiseEnds.Swap(i, SwapIndex);
+		}
+	}
+	const int32 NumPoints = BlueNoiseTiles ? BlueNoiseStarts.Num() : NumCandidates;
+	const float OccupiedRadius = SampleFootprint * HASTE_BLUE_NOISE_OCCUPIED_RADIUS;
+
+	TArray<FHastePlacementCandidate> Candidates;
+	Candidates.Reserve(NumCandidates);
+	int32 NumSamples = 0;
+	for (int32 i = 0; i < NumPoints && NumSamples < NumCandidates; i++) {
+		FVector Start, End;
+		if (BlueNoiseTiles) {
+			Start = BlueNoiseStarts[i];
+			End = BlueNoiseEnds[i];
+			if (OverlapFilter.HasPlacementInColumn(Start, End, OccupiedRadius)) {
+				continue;
+			}
+		}
+		else {
+			GetRandomVectorInBrush(Start, End);
+		}
+		NumSamples++;
+
+		FHastePlacementCandidate Candidate;
+		if (ProjectToSurface(World, Start, End, Candidate.Hit, NAME_HastePaint)) {
+			if (Mask.IsValid() && FMath::FRand() >= Mask->Sample(Candidate.Hit.Location, SampleFootprint)) {
+				continue;
+			}
+			Candidate.Mesh = SelectedBrushMeshes[FMath::RandRange(0, SelectedBrushMeshes.Num() - 1)];
+			Candidate.Transform = FTransform(GetSurfaceRotation(Candidate.Hit.ImpactNormal), Candidate.Hit.Location, BrushScale);
+			Candidates.Add(Candidate);
+		}
+	}
+
+	// Discard the rejected candidates in batches before any transformer or spawn work is done
+	UHastePlacementFilter::ApplyFilters(UISettings->Filters, Candidates);
+	if (UISettings->bRejectOverlaps) {
+		OverlapFilter.FilterCandidates(Candidates);
+	}
+
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(Candidates.Num());
+	for (const FHastePlacementCandidate& Candidate : Candidates) {
+		Transforms.Add(Candidate.Transform);
+	}
+	const int32 Seed = FMath::Rand();
+	ApplyTransformers(Transforms, Seed);
+
+	for (int32 i = 0; i < Candidates.Num(); i++) {
+		SpawnPlacement(Candidates[i].Mesh, Transforms[i], Seed);
+	}
 }
 
 
 /** FEdMode: Called when a key is pressed */
 bool FEdModeHaste::InputKey(FEditorViewportClient* ViewportClient, FViewport* Viewport, FKey Key, EInputEvent Event)
 {
+	// Paint while the left mouse button is held down. Alt is left to the viewport for camera control
+	if (IsPaintMode() && Key == EKeys::LeftMouseButton && !IsAltDown(Viewport)) {
+		if (Event == IE_Pressed && bBrushTraceValid && !bToolActive && !PlacementPipeline.IsRunning()) {
+			BeginStroke(LOCTEXT("HastePaintTransaction", "Haste Paint"));
+			bToolActive = true;
+			ApplyBrush(ViewportClient);
+			return true;
+		}
+		if (Event == IE_Released && bToolActive) {
+			bToolActive = false;
+			EndStroke();
+			return true;
+		}
+	}
+
 	// Rotate if mouse wheel is scrolled
 	if (Key == EKeys::MouseScrollUp || Key == EKeys::MouseScrollDown) {
 		int32 WheelDelta = (Key == EKeys::MouseScrollUp) ? 1 : -1;
@@ -447,6 +983,7 @@ bool FEdModeHaste::InputKey(FEditorViewportClient* ViewportClient, FViewport* Vi
 		else {
 			RotationOffset.Z += AngleDelta;
 		}
+		bViewportRedrawRequested = true;
 		return true;
 	}
 	return false;
@@ -492,38 +1029,63 @@ void FEdModeHaste::ActorSelectionChangeNotify()
 /** Forces real-time perspective viewports */
 void FEdModeHaste::ForceRealTimeViewports(const bool bEnable, const bool bStoreCurrentState)
 {
-	FLevelEditorModule& LevelEditorModule = FModuleManager::GetModuleChecked<FLevelEditorModule>("LevelEditor");
-	TSharedPtr< ILevelViewport > ViewportWindow = LevelEditorModule.GetFirstActiveViewport();
-	if (ViewportWindow.IsValid())
+	for (FLevelEditorViewportClient* Viewport : GEditor->LevelViewportClients)
 	{
-		FEditorViewportClient &Viewport = ViewportWindow->GetLevelViewportClient();
-		if (Viewport.IsPerspective())
+		if (Viewport && Viewport->IsPerspective())
 		{
 			if (bEnable)
 			{
-				Viewport.SetRealtime(bEnable, bStoreCurrentState);
+				Viewport->SetRealtime(bEnable, bStoreCurrentState);
 			}
 			else
 			{
 				const bool bAllowDisable = true;
-				Viewport.RestoreRealtime(bAllowDisable);
+				Viewport->RestoreRealtime(bAllowDisable);
 			}
-
 		}
 	}
 }
 
-bool FEdModeHaste::HandleClick(FEditorViewportClient* InViewportClient, HHitProxy *HitProxy, const FViewportClick &Click)
+void FEdModeHaste::UpdateRealtimeViewports()
 {
-	if (ActiveBrushMesh && !bMeshRotating) {
-		AStaticMeshActor* MeshActor = GetWorld()->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass());
+	const bool bWantRealTime = UISettings && !UISettings->bAdaptiveRealtime;
+	if (bWantRealTime != bRealtimeForced)
+	{
+		// Remember the current state when forcing, so it can be restored when the adaptive mode is turned back on
+		const bool bRememberCurrentState = bWantRealTime;
+		ForceRealTimeViewports(bWantRealTime, bRememberCurrentState);
+		bRealtimeForced = bWantRealTime;
+	}
+}
 
-		// Rename the display name of the new actor in the editor to reflect the mesh that is being created from.
-		FActorLabelUtilities::SetActorLabelUnique(MeshActor, ActiveBrushMesh->GetName());
+void FEdModeHaste::InvalidateViewports()
+{
+	for (FLevelEditorViewportClient* Viewport : GEditor->LevelViewportClients)
+	{
+		if (Viewport)
+		{
+			Viewport->Invalidate();
+		}
+	}
+}
 
-		MeshActor->GetStaticMeshComponent()->SetStaticMesh(ActiveBrushMesh);
-		MeshActor->ReregisterAllComponents();
-		MeshActor->SetActorTransform(BrushCursorTransform);
+bool FEdModeHaste::HandleClick(FEditorViewportClient* InViewportClient, HHitProxy *HitProxy, const FViewportClick &Click)
+{
+	// Clicks are ignored while a bulk placement streams in, as its placements are part of its own transaction
+	const bool bCanPlace = !bMeshRotating && !bBrushPlacementBlocked && !PlacementPipeline.IsRunning();
+	if (IsStampMode()) {
+		if (ActiveStamp && bCanPlace) {
+			BeginStroke(LOCTEXT("HasteStampTransaction", "Haste Stamp"));
+			PlaceStamp(ActiveStamp, StampRootTransform, PlacementSeed);
+			EndStroke();
+
+			ResetBrushMesh();
+		}
+	}
+	else if (ActiveBrushMesh && bCanPlace && !IsPaintMode()) {
+		BeginStroke(LOCTEXT("HastePlaceTransaction", "Haste Place"));
+		SpawnPlacement(ActiveBrushMesh, BrushCursorTransform, PlacementSeed);
+		EndStroke();
 
 		// Switch to another mesh from the list
 		ResetBrushMesh();
@@ -532,20 +1094,580 @@ bool FEdModeHaste::HandleClick(FEditorViewportClient* InViewportClient, HHitProx
 	return FEdMode::HandleClick(InViewportClient, HitProxy, Click);
 }
 
-FTransform FEdModeHaste::ApplyTransformers(const FTransform& BaseTransform)
+AActor* FEdModeHaste::SpawnPlacement(UStaticMesh* Mesh, const FTransform& Transform, int32 Seed)
 {
-	FTransform Transform = BaseTransform;
+	// Spawn at the final transform, so the actor is not moved (and its navigation and lighting dirtied again) afterwards
+	AStaticMeshActor* MeshActor = GetWorld()->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
 
-	if (UISettings) {
-		for (UHasteTransformLogic* TransformLogic : UISettings->Transformers) {
-			if (!TransformLogic) continue;
-			FTransform Offset;
-			TransformLogic->TransformObject(Transform, Offset);
-			Transform = Offset * Transform;
+	// Rename the display name of the new actor in the editor to reflect the mesh that is being created from.
+	// During a stroke the labels are assigned in one pass when the stroke ends
+	if (DeferredInvalidation.IsStrokeActive()) {
+		DeferredInvalidation.AddPlacedActor(MeshActor, Mesh->GetName());
+	}
+	else {
+		FActorLabelUtilities::SetActorLabelUnique(MeshActor, Mesh->GetName());
+	}
+	MeshActor->Tags.Add(FHasteTags::PlacedActor);
+
+	// SetStaticMesh updates the render state, physics and bounds of the registered component, so the components are
+	// not registered a second time. Only the navigation entry is refreshed, and held back until the stroke ends
+	UStaticMeshComponent* MeshComponent = MeshActor->GetStaticMeshComponent();
+	MeshComponent->SetStaticMesh(Mesh);
+	if (GetDefault<UHasteProjectSettings>()->bApplyCullDistanceOnPlacement) {
+		FHasteCullDistance::ApplyToComponent(MeshComponent);
+	}
+	UNavigationSystem::UpdateComponentInNavOctree(*MeshComponent);
+
+	OverlapFilter.AddPlacement(Mesh, Transform, MeshActor->GetStaticMeshComponent());
+	LandscapeCache.AddOccluder(MeshActor->GetStaticMeshComponent()->Bounds.GetBox());
+	if (FHastePlacementJournal* Journal = FHastePlacementJournal::Get()) {
+		Journal->RecordPlacement(Mesh, Transform, MeshActor->GetLevel(), false, Seed);
+	}
+	return MeshActor;
+}
+
+void FEdModeHaste::PlaceStamp(UHasteStamp* Stamp, const FTransform& RootTransform, int32 Seed)
+{
+	TArray<FTransform> WorldTransforms;
+	for (const FHasteStampMeshGroup& Group : Stamp->GetMeshGroups()) {
+		WorldTransforms.Reset(Group.RelativeTransforms.Num());
+		for (const FTransform& RelativeTransform : Group.RelativeTransforms) {
+			WorldTransforms.Add(RelativeTransform * RootTransform);
+		}
+		AddInstancesToContainer(Group.Mesh, WorldTransforms, Seed);
+	}
+}
+
+UHierarchicalInstancedStaticMeshComponent* FEdModeHaste::AddInstancesToContainer(UStaticMesh* Mesh, const TArray<FTransform>& WorldTransforms, int32 Seed)
+{
+	AActor* Container = FHasteInstanceContainers::FindOrCreateContainer(GetWorld()->GetCurrentLevel());
+	UHierarchicalInstancedStaticMeshComponent* Component = FHasteInstanceContainers::FindOrCreateComponent(Container, Mesh);
+	return AddInstancesToComponent(Component, WorldTransforms, Seed) ? Component : nullptr;
+}
+
+bool FEdModeHaste::AddInstancesToComponent(UHierarchicalInstancedStaticMeshComponent* Component, const TArray<FTransform>& WorldTransforms, int32 Seed)
+{
+	const int32 FirstIndex = FHasteInstanceContainers::AddInstances(Component, WorldTransforms);
+	if (FirstIndex == INDEX_NONE) {
+		return false;
+	}
+
+	// Only the new instances are visited, so the cost of an add does not grow with the size of the component
+	UStaticMesh* Mesh = Component->GetStaticMesh();
+	ULevel* Level = Component->GetComponentLevel();
+	if (GetDefault<UHasteProjectSettings>()->bApplyCullDistanceOnPlacement) {
+		FHasteCullDistance::ApplyToNewInstances(Component, FirstIndex, WorldTransforms);
+	}
+
+	FHastePlacementJournal* Journal = FHastePlacementJournal::Get();
+	const FBox MeshBox = FHasteMeshMetadataCache::Get().Get(Mesh).Bounds.GetBox();
+	for (int32 i = 0; i < WorldTransforms.Num(); i++) {
+		const FBox InstanceBox = MeshBox.TransformBy(WorldTransforms[i]);
+		OverlapFilter.AddPlacement(Mesh, WorldTransforms[i], Component, FirstIndex + i);
+		LandscapeCache.AddOccluder(InstanceBox);
+		if (Journal) {
+			Journal->RecordPlacement(Mesh, WorldTransforms[i], Level, true, Seed);
 		}
 	}
+	DeferredInvalidation.AddDirtyLevel(Level);
+	return true;
+}
+
+void FEdModeHaste::FillAroundCursor()
+{
+	if (PlacementPipeline.IsRunning() || bToolActive || SelectedBrushMeshes.Num() == 0 || !BrushHit.bBlockingHit) {
+		return;
+	}
 
-	return Transform;
+	const float HalfSize = UISettings->FillAreaSize * 0.5f;
+	const FBox FillBounds(BrushLocation - FVector(HalfSize), BrushLocation + FVector(HalfSize));
+
+	// The region is added inside the transaction of the job, so undoing the fill forgets it
+	const FText Description = LOCTEXT("HasteFillJob", "Haste Fill");
+	const FScopedTransaction Transaction(Description);
+	ScatterRecords.Modify();
+	const int32 RegionIndex = ScatterRecords.AddRegion(GetWorld()->GetCurrentLevel(), FillBounds, UISettings->ScatterCellSize, FMath::Rand());
+
+	// The region keeps its own palette, so it can be regenerated after the content browser selection changed
+	FHasteScatterRegion& Region = ScatterRecords.GetRegions()[RegionIndex];
+	Region.Meshes = SelectedBrushMeshes;
+
+	TArray<int32> CellIndices;
+	for (int32 CellIndex = 0; CellIndex < Region.Cells.Num(); CellIndex++) {
+		CellIndices.Add(CellIndex);
+	}
+	StartScatterJob(RegionIndex, CellIndices, Description);
+}
+
+void FEdModeHaste::UpdateScatter()
+{
+	bScatterUpdatePending = false;
+	if (PlacementPipeline.IsRunning() || bToolActive || ScatterCheck.IsValid()) {
+		// Try again once the current operation is done
+		bScatterUpdatePending = true;
+		return;
+	}
+
+	// The rules are compared here. The surface is probed on a worker, for the cells whose rules did not change
+	struct FSurfaceProbe
+	{
+		int32 RegionIndex;
+		int32 CellIndex;
+		FBox Bounds;
+		uint32 SurfaceHash;
+	};
+	TArray<FSurfaceProbe> Probes;
+	UWorld* World = GetWorld();
+	TArray<FHasteScatterRegion>& Regions = ScatterRecords.GetRegions();
+	TArray<TArray<int32>> DirtyCells;
+	DirtyCells.SetNum(Regions.Num());
+	for (int32 RegionIndex = 0; RegionIndex < Regions.Num(); RegionIndex++) {
+		FHasteScatterRegion& Region = Regions[RegionIndex];
+		if (!Region.Level.IsValid() || Region.Level->OwningWorld != World) continue;
+
+		const uint32 RegionRuleHash = FHasteScatterRecords::HashRules(UISettings, Region.Meshes);
+		for (int32 CellIndex = 0; CellIndex < Region.Cells.Num(); CellIndex++) {
+			const FHasteScatterCell& Cell = Region.Cells[CellIndex];
+			if (Cell.RuleHash != FHasteScatterRecords::HashCellRules(UISettings, Cell, RegionRuleHash)) {
+				DirtyCells[RegionIndex].Add(CellIndex);
+			}
+			else {
+				FSurfaceProbe Probe;
+				Probe.RegionIndex = RegionIndex;
+				Probe.CellIndex = CellIndex;
+				Probe.Bounds = Cell.Bounds;
+				Probe.SurfaceHash = Cell.SurfaceHash;
+				Probes.Add(Probe);
+			}
+		}
+	}
+
+	const TArray<AActor*> IgnoredActors = FHasteInstanceContainers::GetContainers(World);
+	ScatterCheck = Async<TArray<TArray<int32>>>(EAsyncExecution::ThreadPool, [World, IgnoredActors, Probes, DirtyCells]() {
+		TArray<uint8> SurfaceChanged;
+		SurfaceChanged.AddZeroed(Probes.Num());
+		ParallelFor(Probes.Num(), [&](int32 ProbeIndex) {
+			const FSurfaceProbe& Probe = Probes[ProbeIndex];
+			SurfaceChanged[ProbeIndex] = (Probe.SurfaceHash != HashScatterSurface(World, Probe.Bounds, IgnoredActors)) ? 1 : 0;
+		});
+
+		TArray<TArray<int32>> Result = DirtyCells;
+		for (int32 ProbeIndex = 0; ProbeIndex < Probes.Num(); ProbeIndex++) {
+			if (SurfaceChanged[ProbeIndex]) {
+				Result[Probes[ProbeIndex].RegionIndex].Add(Probes[ProbeIndex].CellIndex);
+			}
+		}
+		for (TArray<int32>& RegionCells : Result) {
+			RegionCells.Sort();
+		}
+		return Result;
+	});
+}
+
+void FEdModeHaste::FinishScatterCheck()
+{
+	const TArray<TArray<int32>> DirtyCells = ScatterCheck.Get();
+	ScatterCheck = TFuture<TArray<TArray<int32>>>();
+
+	// Something else started while the surface was probed. Check again once it is done
+	if (PlacementPipeline.IsRunning() || bToolActive) {
+		bScatterUpdatePending = true;
+		return;
+	}
+
+	// One region at a time. The job schedules another update when it finishes, which picks up the next region
+	TArray<FHasteScatterRegion>& Regions = ScatterRecords.GetRegions();
+	for (int32 RegionIndex = 0; RegionIndex < DirtyCells.Num() && RegionIndex < Regions.Num(); RegionIndex++) {
+		if (DirtyCells[RegionIndex].Num() > 0) {
+			const FText Description = LOCTEXT("HasteUpdateScatterJob", "Haste Update Scatter");
+			const FScopedTransaction Transaction(Description);
+			ScatterRecords.Modify();
+			StartScatterJob(RegionIndex, DirtyCells[RegionIndex], Description);
+			return;
+		}
+	}
+}
+
+void FEdModeHaste::CancelScatterCheck()
+{
+	if (ScatterCheck.IsValid()) {
+		ScatterCheck.Wait();
+		ScatterCheck = TFuture<TArray<TArray<int32>>>();
+	}
+}
+
+void FEdModeHaste::RestoreScatterRecords()
+{
+	if (ScatterRecords.IsStale()) {
+		// A running job and a pending check hold indices into the records
+		PlacementPipeline.Cancel();
+		CancelScatterCheck();
+		ScatterRecords.Restore();
+	}
+}
+
+/** Work shared by the stages of a scatter job */
+struct FHasteScatterJobData
+{
+	/** Bounds and seeds of the cells being generated */
+	TArray<FHasteScatterCell> Cells;
+	TArray<int32> CellIndices;
+	int32 SamplesPerCell;
+
+	/** Blue noise positions inside each cell. Empty when the samples are random */
+	TArray<TArray<FVector2D>> CellPoints;
+
+	TArray<UStaticMesh*> Meshes;
+	TArray<UHastePlacementFilter*> Filters;
+	TArray<UHasteTransformLogic*> Transformers;
+	TArray<AActor*> IgnoredActors;
+	FHasteLandscapeCache Heights;
+
+	/** The container components the meshes are added to, looked up once per job instead of on every commit */
+	TMap<UStaticMesh*, TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent>> Components;
+
+	/** The surface seen by the filters in each cell. Only written by the process stage, which never runs concurrently */
+	TArray<FHasteSurfaceStats> CellStats;
+
+	/** Signature of the surface under each cell, probed on a worker while the job runs */
+	TFuture<TArray<uint32>> SurfaceHashes;
+
+	/** The journal transaction of the job, which the instances streamed in after the transaction closed belong to */
+	int32 JournalTransaction;
+
+	/** Optional density mask, and the spacing between samples it is read at */
+	TSharedPtr<const FHasteDensityMask, ESPMode::ThreadSafe> Mask;
+	float SampleFootprint;
+};
+
+void FEdModeHaste::StartScatterJob(int32 RegionIndex, const TArray<int32>& CellIndices, const FText& Description)
+{
+	UWorld* World = GetWorld();
+	FHasteScatterRegion& Region = ScatterRecords.GetRegions()[RegionIndex];
+	Region.Meshes.Remove(nullptr);
+	if (Region.Meshes.Num() == 0 || CellIndices.Num() == 0) {
+		return;
+	}
+
+	TSharedRef<FHasteScatterJobData, ESPMode::ThreadSafe> Data = MakeShareable(new FHasteScatterJobData);
+	Data->CellIndices = CellIndices;
+	Data->SamplesPerCell = FMath::Max(1, FMath::RoundToInt(UISettings->PaintDensity * FMath::Square(Region.CellSize) / (1000.f * 1000.f)));
+	Data->Meshes = Region.Meshes;
+	Data->Filters = UISettings->Filters;
+	Data->Transformers = UISettings->Transformers;
+	Data->Mask = UpdateDensityMask();
+	Data->SampleFootprint = Region.CellSize / FMath::Sqrt(float(Data->SamplesPerCell));
+
+	// Clear what the cells held before. The cells are stamped with the rules they were generated from once the
+	// surface under them is known
+	const uint32 RegionRuleHash = FHasteScatterRecords::HashRules(UISettings, Region.Meshes);
+	const uint32 RuleRevision = ScatterRuleRevision;
+	TArray<FHasteScatterCell*> Cells;
+	FBox JobBounds(0);
+	for (int32 CellIndex : CellIndices) {
+		FHasteScatterCell& Cell = Region.Cells[CellIndex];
+		Cells.Add(&Cell);
+		JobBounds += Cell.Bounds;
+	}
+
+	// Nested in the transaction the caller recorded the scatter records in.
+	// The transaction only records the containers before the job adds to them, so the whole job is undone in one step
+	// without a transaction being held open while it streams in. Edits made during the job get transactions of their own
+	{
+		const FScopedTransaction Transaction(Description);
+		TSet<AActor*> ChangedContainers;
+		for (FHasteScatterCell* Cell : Cells) {
+			for (const FHasteScatterPlacement& Placement : Cell->Placements) {
+				if (UPrimitiveComponent* Component = Placement.Component.Get()) {
+					ChangedContainers.Add(Component->GetOwner());
+				}
+			}
+		}
+		if (FHasteScatterRecords::RemovePlacements(Cells) > 0) {
+			UpdateOverlapFilter();
+			for (AActor* ChangedContainer : ChangedContainers) {
+				OverlapFilter.UpdateActor(ChangedContainer);
+			}
+		}
+
+		AActor* Container = FHasteInstanceContainers::FindOrCreateContainer(Region.Level.Get());
+		for (UStaticMesh* Mesh : Region.Meshes) {
+			if (UHierarchicalInstancedStaticMeshComponent* Component = FHasteInstanceContainers::FindOrCreateComponent(Container, Mesh, true)) {
+				Component->Modify();
+				Data->Components.Add(Mesh, Component);
+			}
+		}
+
+		// Undoing the transaction removes everything the job adds, so the journal files the job under it
+		FHastePlacementJournal* Journal = FHastePlacementJournal::Get();
+		Data->JournalTransaction = Journal ? Journal->GetTransaction() : 0;
+	}
+	DeferredInvalidation.BeginStroke(World);
+
+	// Looked up after the container was created, so the job never traces against its own instances
+	Data->IgnoredActors = FHasteInstanceContainers::GetContainers(World);
+	TArray<FBox> CellBounds;
+	for (FHasteScatterCell* Cell : Cells) {
+		Data->Cells.Add(*Cell);
+		CellBounds.Add(Cell->Bounds);
+	}
+	Data->CellStats.SetNum(Cells.Num());
+
+	const TArray<AActor*> IgnoredActors = Data->IgnoredActors;
+	Data->SurfaceHashes = Async<TArray<uint32>>(EAsyncExecution::ThreadPool, [World, IgnoredActors, CellBounds]() {
+		TArray<uint32> Hashes;
+		Hashes.AddZeroed(CellBounds.Num());
+		ParallelFor(CellBounds.Num(), [&](int32 CellSlot) {
+			Hashes[CellSlot] = HashScatterSurface(World, CellBounds[CellSlot], IgnoredActors);
+		});
+		return Hashes;
+	});
+
+	// The blue noise tiles are seeded by the region, so a regenerated cell gets the same points back
+	if (UHasteBlueNoiseTiles* BlueNoiseTiles = GetBlueNoiseTiles()) {
+		const float TileSize = BlueNoiseTiles->GetTileSize(UISettings->PaintDensity);
+		int32 MaxCellPoints = 1;
+		Data->CellPoints.SetNum(Data->Cells.Num());
+		for (int32 CellSlot = 0; CellSlot < Data->Cells.Num(); CellSlot++) {
+			const FBox& Bounds = Data->Cells[CellSlot].Bounds;
+			BlueNoiseTiles->GetPoints(FBox2D(FVector2D(Bounds.Min), FVector2D(Bounds.Max)), TileSize, Region.Seed, Data->CellPoints[CellSlot]);
+			MaxCellPoints = FMath::Max(MaxCellPoints, Data->CellPoints[CellSlot].Num());
+		}
+		Data->SamplesPerCell = MaxCellPoints;
+	}
+
+	// The workers project on to their own copy of the landscape heights, which ignores the Haste instances
+	static FName NAME_HasteScatter = FName(TEXT("HasteScatter"));
+	FHitResult SurfaceHit;
+	const FVector Center = JobBounds.GetCenter();
+	if (HasteTrace(World, SurfaceHit, FVector(Center.X, Center.Y, JobBounds.Max.Z), FVector(Center.X, Center.Y, JobBounds.Min.Z), NAME_HasteScatter, false, Data->IgnoredActors)) {
+		Data->Heights.CacheRegion(World, SurfaceHit, JobBounds, Data->IgnoredActors);
+	}
+
+	FHastePlacementJob Job;
+	Job.Description = Description;
+	Job.NumSamples = Data->SamplesPerCell * Data->Cells.Num();
+	Job.Seed = FMath::Rand();
+
+	// Every sample is derived from the seed of its cell, so a regenerated cell does not depend on the other cells
+	const FVector Scale = BrushScale;
+	Job.SampleAndTrace = [this, World, Data, Scale](int32 SampleIndex, FRandomStream& Random, FHastePlacementCandidate& OutCandidate) {
+		const int32 CellSlot = SampleIndex / Data->SamplesPerCell;
+		const int32 CellSample = SampleIndex % Data->SamplesPerCell;
+		const FHasteScatterCell& Cell = Data->Cells[CellSlot];
+		FRandomStream CellRandom(HashCombine(uint32(Cell.Seed), uint32(CellSample)));
+
+		float X, Y;
+		if (Data->CellPoints.Num() > 0) {
+			const TArray<FVector2D>& Points = Data->CellPoints[CellSlot];
+			if (CellSample >= Points.Num()) {
+				return false;
+			}
+			X = Points[CellSample].X;
+			Y = Points[CellSample].Y;
+		}
+		else {
+			X = CellRandom.FRandRange(Cell.Bounds.Min.X, Cell.Bounds.Max.X);
+			Y = CellRandom.FRandRange(Cell.Bounds.Min.Y, Cell.Bounds.Max.Y);
+		}
+		UStaticMesh* Mesh = Data->Meshes[CellRandom.RandRange(0, Data->Meshes.Num() - 1)];
+
+		// Test the mask before tracing. The roll is always drawn, so the other samples of the cell do not change with the mask
+		const float MaskRoll = CellRandom.FRand();
+		if (Data->Mask.IsValid() && MaskRoll >= Data->Mask->Sample(FVector(X, Y, 0), Data->SampleFootprint)) {
+			return false;
+		}
+
+		const FVector Start(X, Y, Cell.Bounds.Max.Z);
+		const FVector End(X, Y, Cell.Bounds.Min.Z);
+		if (!Data->Heights.Trace(Start, End, OutCandidate.Hit) && !HasteTrace(World, OutCandidate.Hit, Start, End, NAME_HasteScatter, false, Data->IgnoredActors)) {
+			return false;
+		}
+		OutCandidate.Mesh = Mesh;
+		OutCandidate.Transform = FTransform(GetSurfaceRotation(OutCandidate.Hit.ImpactNormal), OutCandidate.Hit.Location, Scale);
+		return true;
+	};
+
+	Job.bProcessOnWorker = UHastePlacementFilter::AreThreadSafe(Data->Filters) && UHasteTransformLogic::AreThreadSafe(Data->Transformers);
+	Job.Process = [Data](TArray<FHastePlacementCandidate>& Candidates, int32 Seed) {
+		// Filter and transform cell by cell. A cell can be split across batches, so the seed of a run also
+		// depends on its first sample, or the runs of a cell would get the same transforms
+		TArray<FHastePlacementCandidate> Processed;
+		TArray<FHastePlacementCandidate> CellCandidates;
+		TArray<FTransform> Transforms;
+		int32 RunStart = 0;
+		while (RunStart < Candidates.Num()) {
+			const int32 CellSlot = Candidates[RunStart].SampleIndex / Data->SamplesPerCell;
+			int32 RunEnd = RunStart + 1;
+			while (RunEnd < Candidates.Num() && Candidates[RunEnd].SampleIndex / Data->SamplesPerCell == CellSlot) {
+				RunEnd++;
+			}
+
+			CellCandidates.Reset();
+			CellCandidates.Append(Candidates.GetData() + RunStart, RunEnd - RunStart);
+			for (const FHastePlacementCandidate& Candidate : CellCandidates) {
+				Data->CellStats[CellSlot].Add(Candidate.Hit);
+			}
+			UHastePlacementFilter::ApplyFilters(Data->Filters, CellCandidates);
+
+			Transforms.Reset();
+			for (const FHastePlacementCandidate& Candidate : CellCandidates) {
+				Transforms.Add(Candidate.Transform);
+			}
+			const uint32 RunSeed = HashCombine(uint32(Data->Cells[CellSlot].Seed), uint32(Candidates[RunStart].SampleIndex % Data->SamplesPerCell));
+			UHasteTransformLogic::ApplyTransformers(Data->Transformers, Transforms, int32(RunSeed));
+			for (int32 i = 0; i < CellCandidates.Num(); i++) {
+				CellCandidates[i].Transform = Transforms[i];
+			}
+			Processed.Append(CellCandidates);
+			RunStart = RunEnd;
+		}
+		Candidates = MoveTemp(Processed);
+	};
+
+	// Scattered meshes are added as instances, grouped by mesh so every slice is one batched add per mesh
+	Job.Commit = [this, RegionIndex, Data](TArray<FHastePlacementCandidate>& Candidates) {
+		FHasteScopedJournalTransaction JournalTransaction(Data->JournalTransaction);
+		if (UISettings->bRejectOverlaps) {
+			OverlapFilter.FilterCandidates(Candidates);
+		}
+
+		TMap<UStaticMesh*, TArray<int32>> CandidatesByMesh;
+		for (int32 i = 0; i < Candidates.Num(); i++) {
+			CandidatesByMesh.FindOrAdd(Candidates[i].Mesh).Add(i);
+		}
+
+		FHasteScatterRegion& Region = ScatterRecords.GetRegions()[RegionIndex];
+		TArray<FTransform> Transforms;
+		for (auto& Entry : CandidatesByMesh) {
+			Transforms.Reset();
+			for (int32 i : Entry.Value) {
+				Transforms.Add(Candidates[i].Transform);
+			}
+
+			UHierarchicalInstancedStaticMeshComponent* Component = Data->Components.FindRef(Entry.Key).Get();
+			if (!Component) {
+				// The component was removed while the job ran, e.g. by an undo
+				AActor* Container = FHasteInstanceContainers::FindOrCreateContainer(Region.Level.Get());
+				Component = FHasteInstanceContainers::FindOrCreateComponent(Container, Entry.Key, true);
+				Data->Components.Add(Entry.Key, Component);
+			}
+			if (!Component || !AddInstancesToComponent(Component, Transforms, Region.Seed)) {
+				continue;
+			}
+			for (int32 i : Entry.Value) {
+				const int32 CellIndex = Data->CellIndices[Candidates[i].SampleIndex / Data->SamplesPerCell];
+				FHasteScatterPlacement Placement;
+				Placement.Component = Component;
+				Placement.Transform = Candidates[i].Transform;
+				Region.Cells[CellIndex].Placements.Add(Placement);
+			}
+		}
+	};
+
+	Job.OnFinished = [this, RegionIndex, Data, RegionRuleHash, RuleRevision](bool bCancelled) {
+		DeferredInvalidation.EndStroke();
+
+		// The cells of a cancelled job, or of a job that ran while the rules were edited, are left to be
+		// regenerated by the next update
+		const bool bRulesChanged = bCancelled || RuleRevision != ScatterRuleRevision;
+		const TArray<uint32>& SurfaceHashes = Data->SurfaceHashes.Get();
+		FHasteScatterRegion& Region = ScatterRecords.GetRegions()[RegionIndex];
+		for (int32 CellSlot = 0; CellSlot < Data->CellIndices.Num(); CellSlot++) {
+			FHasteScatterCell& Cell = Region.Cells[Data->CellIndices[CellSlot]];
+			Cell.SurfaceHash = SurfaceHashes[CellSlot];
+			Cell.SurfaceStats = Data->CellStats[CellSlot];
+			Cell.RuleHash = bRulesChanged ? 0 : FHasteScatterRecords::HashCellRules(UISettings, Cell, RegionRuleHash);
+		}
+
+		// Other regions may be waiting for their update
+		if (!bCancelled) {
+			bScatterUpdatePending = true;
+		}
+	};
+
+	Job.ReferencedObjects.Append(Data->Meshes);
+	Job.ReferencedObjects.Append(Data->Filters);
+	Job.ReferencedObjects.Append(Data->Transformers);
+
+	if (!PlacementPipeline.Start(Job)) {
+		DeferredInvalidation.EndStroke();
+		Data->SurfaceHashes.Wait();
+		for (int32 CellIndex : CellIndices) {
+			Region.Cells[CellIndex].RuleHash = 0;
+		}
+	}
+}
+
+void FEdModeHaste::BeginStroke(const FText& Description)
+{
+	GEditor->BeginTransaction(Description);
+	DeferredInvalidation.BeginStroke(GetWorld());
+}
+
+void FEdModeHaste::EndStroke()
+{
+	// Flush inside the transaction, so the label changes are undone together with the placements
+	DeferredInvalidation.EndStroke();
+	GEditor->EndTransaction();
+}
+
+void FEdModeHaste::ApplyCullDistancesToLevel()
+{
+	const FScopedTransaction Transaction(LOCTEXT("HasteApplyCullDistances", "Apply Haste Cull Distances"));
+	const int32 NumModified = FHasteCullDistance::ApplyToWorld(GetWorld());
+
+	FNotificationInfo Info(FText::Format(LOCTEXT("HasteCullDistancesApplied", "Updated the cull distance of {0} meshes"), FText::AsNumber(NumModified)));
+	Info.ExpireDuration = 3.0f;
+	FSlateNotificationManager::Get().AddNotification(Info);
+}
+
+void FEdModeHaste::RemoveDuplicatesInLevel()
+{
+	if (PlacementPipeline.IsRunning()) {
+		return;
+	}
+
+	FHasteDuplicateTolerance Tolerance;
+	Tolerance.Position = UISettings->DuplicatePositionTolerance;
+	Tolerance.RotationDegrees = UISettings->DuplicateRotationTolerance;
+	Tolerance.Scale = UISettings->DuplicateScaleTolerance;
+	Tolerance.bIncludeNested = UISettings->bRemoveNestedDuplicates;
+
+	FHasteDuplicateScanResult Result;
+	FHasteDuplicateScan::Scan(GetWorld(), Tolerance, FHasteMeshMetadataCache::Get(), Result);
+
+	int32 NumRemoved = 0;
+	if (Result.NumDuplicates + Result.NumNested > 0) {
+		const FScopedTransaction Transaction(LOCTEXT("HasteRemoveDuplicates", "Remove Haste Duplicates"));
+		NumRemoved = FHasteDuplicateScan::Remove(GetWorld(), Result);
+
+		// Deleted actors are dropped from the overlap filter by the delete callback
+		for (auto& Entry : Result.Instances) {
+			OverlapFilter.UpdateActor(Entry.Key->GetOwner());
+		}
+		LandscapeCache.Reset();
+	}
+
+	FNotificationInfo Info(FText::Format(LOCTEXT("HasteDuplicatesRemoved", "Removed {0} meshes ({1} duplicates, {2} hidden inside larger copies)"),
+		FText::AsNumber(NumRemoved), FText::AsNumber(Result.NumDuplicates), FText::AsNumber(Result.NumNested)));
+	Info.ExpireDuration = 3.0f;
+	FSlateNotificationManager::Get().AddNotification(Info);
+}
+
+FTransform FEdModeHaste::ApplyTransformers(const FTransform& BaseTransform, int32 Seed)
+{
+	TArray<FTransform> Transforms;
+	Transforms.Add(BaseTransform);
+	ApplyTransformers(Transforms, Seed);
+	return Transforms[0];
+}
+
+void FEdModeHaste::ApplyTransformers(TArray<FTransform>& Transforms, int32 Seed)
+{
+	if (UISettings) {
+		UHasteTransformLogic::ApplyTransformers(UISettings->Transformers, Transforms, Seed);
+	}
 }
 
 FVector FEdModeHaste::GetWidgetLocation() const
@@ -587,6 +1709,7 @@ bool FEdModeHaste::InputDelta(FEditorViewportClient* InViewportClient, FViewport
 			RotationOffset.X += AngleDelta;
 		}
 		UpdateBrushRotation();
+		bViewportRedrawRequested = true;
 		return true;
 	}
 	return FEdMode::InputDelta(InViewportClient, InViewport, InDrag, InRot, InScale);
@@ -2,6 +2,13 @@
 
 #pragma once
 #include "EdMode.h"
+#include "Placement/HasteOverlapFilter.h"
+#include "Placement/HasteLandscapeCache.h"
+#include "Placement/HasteDeferredInvalidation.h"
+#include "Placement/HastePlacementPipeline.h"
+#include "Placement/HasteScatterRecord.h"
+#include "Placement/HasteDensityMask.h"
+#include "Placement/HasteMeshMetadata.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogHasteMode, Log, All);
 
@@ -54,6 +61,12 @@ public:
 	 */
 	virtual bool CapturedMouseMove(FEditorViewportClient* InViewportClient, FViewport* InViewport, int32 InMouseX, int32 InMouseY) override;
 
+	/** FEdMode: Called when the mouse enters a viewport */
+	virtual bool MouseEnter(FEditorViewportClient* ViewportClient, FViewport* Viewport, int32 x, int32 y) override;
+
+	/** FEdMode: Called when the mouse leaves a viewport */
+	virtual bool MouseLeave(FEditorViewportClient* ViewportClient, FViewport* Viewport) override;
+
 	/** FEdMode: Called when a mouse button is pressed */
 	virtual bool StartTracking(FEditorViewportClient* InViewportClient, FViewport* InViewport) override;
 
@@ -107,6 +120,12 @@ public:
 	/** Forces real-time perspective viewports */
 	void ForceRealTimeViewports(const bool bEnable, const bool bStoreCurrentState);
 
+	/** Forces or restores real-time viewports when the adaptive real-time setting changes */
+	void UpdateRealtimeViewports();
+
+	/** Redraw all the level viewports on the next frame */
+	void InvalidateViewports();
+
 	/** Trace under the mouse cursor and update brush position */
 	void HasteBrushTrace(FEditorViewportClient* ViewportClient, int32 MouseX, int32 MouseY);
 
@@ -114,17 +133,97 @@ public:
 	returns a line segment inside the sphere parallel to the view direction */
 	void GetRandomVectorInBrush(FVector& OutStart, FVector& OutEnd);
 
+	/** Vertical start/end points through the sphere brush, for every blue noise point inside it */
+	void GetBlueNoiseVectorsInBrush(class UHasteBlueNoiseTiles* Tiles, TArray<FVector>& OutStarts, TArray<FVector>& OutEnds);
+
 	/** Apply brush */
 	void ApplyBrush(FEditorViewportClient* ViewportClient);
 
+	/** Returns true if meshes are painted instead of placed one at a time */
+	bool IsPaintMode() const;
+
+	/** Returns true if stamps are placed instead of single meshes */
+	bool IsStampMode() const;
+
 	void ResetBrushMesh();
 
+	/** Re-applies the project wide cull distance rule to every mesh placed by Haste in the level */
+	void ApplyCullDistancesToLevel();
+
+	/** Removes the placements that duplicate, or are hidden inside, another placement of the same mesh */
+	void RemoveDuplicatesInLevel();
+
+	/** Scatters the selected meshes over a square area around the last cursor location, streamed in over several frames */
+	void FillAroundCursor();
+
+	/** Regenerates the filled cells whose rules or surface changed since they were generated */
+	void UpdateScatter();
+
+	/** Returns true while a bulk placement is streaming in */
+	bool IsPlacementJobRunning() const { return PlacementPipeline.IsRunning(); }
+
 	void UpdateBrushRotation();
 
 	static FEditorModeID EM_Haste;
 
 private:
-	FTransform ApplyTransformers(const FTransform& BaseTransform);
+	FTransform ApplyTransformers(const FTransform& BaseTransform, int32 Seed);
+
+	/** Run the transformer stack over a batch of placements */
+	void ApplyTransformers(TArray<FTransform>& Transforms, int32 Seed);
+
+	/** Find the rotation that aligns a placement to the surface normal */
+	FQuat GetSurfaceRotation(const FVector& SurfaceNormal) const;
+
+	/** Open a transaction for a group of placements made while the mouse is held. Editor notifications are deferred until the stroke ends */
+	void BeginStroke(const FText& Description);
+	void EndStroke();
+
+	/** Spawn a mesh into the level and register it with the overlap filter. The seed of the transformers is recorded in the journal */
+	AActor* SpawnPlacement(UStaticMesh* Mesh, const FTransform& Transform, int32 Seed);
+
+	/** Add every mesh of the stamp as instances into the Haste container of the current level */
+	void PlaceStamp(class UHasteStamp* Stamp, const FTransform& RootTransform, int32 Seed);
+
+	/** Add the meshes as instances into the Haste container of the current level and register them with the overlap filter */
+	class UHierarchicalInstancedStaticMeshComponent* AddInstancesToContainer(UStaticMesh* Mesh, const TArray<FTransform>& WorldTransforms, int32 Seed);
+
+	/** Add the meshes as instances into a container component that was already looked up. Returns false if nothing was added */
+	bool AddInstancesToComponent(class UHierarchicalInstancedStaticMeshComponent* Component, const TArray<FTransform>& WorldTransforms, int32 Seed);
+
+	/** Generate the cells of a scatter region through the placement pipeline, replacing what they held before */
+	void StartScatterJob(int32 RegionIndex, const TArray<int32>& CellIndices, const FText& Description);
+
+	/** Regenerates the dirty cells found by a finished surface check */
+	void FinishScatterCheck();
+
+	/** Drops a surface check that is still running. Waits for it, as it traces against the world */
+	void CancelScatterCheck();
+
+	/** Switches the scatter records to the ones of the transaction that is current after an undo or redo */
+	void RestoreScatterRecords();
+
+	/** Project a segment on to the surface, using the cached landscape heights when possible */
+	bool ProjectToSurface(UWorld* World, const FVector& Start, const FVector& End, FHitResult& OutHit, FName TraceTag);
+
+	/** Keep the overlap filter in sync with the settings and the world */
+	void UpdateOverlapFilter();
+
+	/** The blue noise tile set selected in the settings, or the built-in one. Null if blue noise sampling is off */
+	class UHasteBlueNoiseTiles* GetBlueNoiseTiles();
+
+	/** Decode the density mask selected in the settings, if it changed. Returns null if there is no mask */
+	TSharedPtr<const FHasteDensityMask, ESPMode::ThreadSafe> UpdateDensityMask();
+	TSharedRef<const FHasteDensityMask, ESPMode::ThreadSafe> BuildDensityMask(UTexture2D* Texture, class ULandscapeLayerInfoObject* Layer);
+
+	void OnHastePlacementMoved(AActor* Actor);
+	void OnHastePlacementDeleted(AActor* Actor);
+	void OnMapChange(uint32 MapChangeFlags);
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+
+	/** Drops everything derived from the mesh, after it was edited or reimported */
+	void OnMeshMetadataInvalidated(UStaticMesh* Mesh);
 
 private:
 	bool bBrushTraceValid;
@@ -132,11 +231,34 @@ private:
 	FVector BrushScale;
 	FQuat BrushRotation;
 	FTransform BrushCursorTransform;
+	FHitResult BrushHit;
+	bool bBrushPlacementBlocked;
 	FIntVector LastMousePosition;
 
+	/** The viewport under the mouse cursor. Only used for comparison, never dereferenced */
+	FEditorViewportClient* HoveredViewportClient;
+
+	/** Frame number of the last brush trace, so the trace runs once per frame regardless of the number of viewports */
+	uint64 LastBrushTraceFrame;
+
+	/** True if the perspective viewports were forced to real-time by this mode */
+	bool bRealtimeForced;
+
+	/** Set when the brush appearance changed outside of the trace (e.g. palette or rotation offset) */
+	bool bViewportRedrawRequested;
+
+	/** Camera of the hovered viewport during the last trace */
+	FVector LastViewLocation;
+	FRotator LastViewRotation;
+
 	FVector BrushTraceDirection;
 	TArray<UStaticMesh*> SelectedBrushMeshes;
 	UStaticMesh* ActiveBrushMesh;
+	TArray<class UHasteStamp*> SelectedStamps;
+	class UHasteStamp* ActiveStamp;
+
+	/** Root of the stamp under the cursor, with the transformers applied */
+	FTransform StampRootTransform;
 	UStaticMesh* DefaultBrushMesh;
 	UStaticMeshComponent* BrushMeshComponent;
 
@@ -148,7 +270,41 @@ private:
 
 	FVector RotationOffset;
 
+	/** Seeds the transformers of the next single placement, so the placed mesh matches the cursor */
+	int32 PlacementSeed;
+
 	FDelegateHandle ContentBrowserSelectionChangeDelegate;
+	FDelegateHandle LevelActorDeletedDelegate;
+	FDelegateHandle ActorMovedDelegate;
+	FDelegateHandle ObjectPropertyChangedDelegate;
+	FDelegateHandle MeshInvalidatedDelegate;
+
+	FHasteOverlapFilter OverlapFilter;
+	FHasteLandscapeCache LandscapeCache;
+	FHasteDeferredInvalidation DeferredInvalidation;
+	FHasteScatterRecords ScatterRecords;
+
+	/** Set when the settings changed, so the filled cells are checked on the next tick */
+	bool bScatterUpdatePending;
+
+	/** The dirty cells of every region. The surface under the cells is probed on a worker */
+	TFuture<TArray<TArray<int32>>> ScatterCheck;
+
+	/** Bumped by every edit of the scatter rules, so a job that ran during an edit leaves its cells to be regenerated */
+	uint32 ScatterRuleRevision;
+
+	/** The decoded density mask, shared with the workers of a running job */
+	TSharedPtr<const FHasteDensityMask, ESPMode::ThreadSafe> DensityMask;
+	uint32 DensityMaskKey;
+
+	/** Generated on first use when blue noise sampling is on and no tile set is assigned */
+	class UHasteBlueNoiseTiles* DefaultBlueNoiseTiles;
+
+	/** Seeds the blue noise tiles of the paint brush. Fixed for the session, so strokes fill the gaps between earlier strokes */
+	int32 BlueNoiseSeed;
 
 	class UHasteEdModeSettings* UISettings;
+
+	/** Declared last, so the members its job callbacks touch are still alive when it finishes a job on destruction */
+	FHastePlacementPipeline PlacementPipeline;
 };
\ No newline at end of file
@@ -6,4 +6,25 @@ UHasteEdModeSettings::UHasteEdModeSettings(const FObjectInitializer& ObjectIniti
 	: Super(ObjectInitializer) 
 {
 	bRotateOnScroll = true;
+	bAdaptiveRealtime = true;
+	PlacementMode = EHastePlacementMode::Single;
+	PaintBrushRadius = 200.0f;
+	PaintDensity = 20.0f;
+	SampleMode = EHasteSampleMode::Random;
+	BlueNoiseTiles = nullptr;
+	bRejectOverlaps = true;
+	OverlapShape = EHasteBoundsShape::Sphere;
+	OverlapBoundsScale = 1.0f;
+	FillAreaSize = 10000.0f;
+	ScatterCellSize = 2000.0f;
+	bUpdateScatterOnChange = true;
+	DensityMaskTexture = nullptr;
+	DensityMaskChannel = EHasteMaskChannel::Red;
+	DensityMaskOrigin = FVector2D(-50000.0f, -50000.0f);
+	DensityMaskSize = FVector2D(100000.0f, 100000.0f);
+	DensityMaskLayer = nullptr;
+	DuplicatePositionTolerance = 1.0f;
+	DuplicateRotationTolerance = 1.0f;
+	DuplicateScaleTolerance = 0.01f;
+	bRemoveNestedDuplicates = true;
 }
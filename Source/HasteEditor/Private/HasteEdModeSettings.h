@@ -1,8 +1,47 @@
 //$ Copyright 2015 Ali Akbar, Code Respawn Technologies Pvt Ltd - All Rights Reserved $//
 #pragma once
 #include "Transformer/HasteTransformLogic.h"
+#include "Filter/HastePlacementFilter.h"
+#include "Placement/HastePlacement.h"
 #include "HasteEdModeSettings.generated.h"
 
+UENUM()
+enum class EHastePlacementMode : uint8
+{
+	/** Place a single mesh under the cursor on every click */
+	Single,
+
+	/** Scatter meshes inside the brush while the mouse button is held down */
+	Paint,
+
+	/** Place a whole stamp asset as instances on every click */
+	Stamp
+};
+
+/** Texture channel read by a density mask */
+UENUM()
+enum class EHasteMaskChannel : uint8
+{
+	Red,
+	Green,
+	Blue,
+	Alpha
+};
+
+/** How the paint and fill positions are chosen */
+UENUM()
+enum class EHasteSampleMode : uint8
+{
+	/** Independent random positions */
+	Random,
+
+	/** Pre-spaced points from a blue noise tile set, which cover the area evenly without clumps */
+	BlueNoise
+};
+
+class ULandscapeLayerInfoObject;
+class UHasteBlueNoiseTiles;
+
 UCLASS()
 class UHasteEdModeSettings : public UObject {
 	GENERATED_UCLASS_BODY()
@@ -13,8 +52,95 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Instanced, SimpleDisplay, Category = Haste)
 	TArray<UHasteTransformLogic*> Transformers;
 
+	/** Rules that decide if a mesh may be placed on the surface under it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Instanced, SimpleDisplay, Category = Haste)
+	TArray<UHastePlacementFilter*> Filters;
+
 
 	/** Lets you emit your own markers into the scene */
 	UPROPERTY(EditAnywhere, Category = Haste)
 	bool bRotateOnScroll;
+
+	/** Redraw the viewports only when the brush or camera changes, instead of forcing them to be real-time */
+	UPROPERTY(EditAnywhere, Category = Haste)
+	bool bAdaptiveRealtime;
+
+	/** Controls how meshes are placed when clicking in the viewport */
+	UPROPERTY(EditAnywhere, Category = Haste)
+	EHastePlacementMode PlacementMode;
+
+	/** Radius of the paint brush */
+	UPROPERTY(EditAnywhere, Category = Paint, meta = (ClampMin = "1"))
+	float PaintBrushRadius;
+
+	/** Number of meshes to paint or fill per 1000x1000 units of area */
+	UPROPERTY(EditAnywhere, Category = Paint, meta = (ClampMin = "0"))
+	float PaintDensity;
+
+	/** How the positions inside the brush or fill area are chosen */
+	UPROPERTY(EditAnywhere, Category = Paint)
+	EHasteSampleMode SampleMode;
+
+	/** Tile set used by the blue noise sampling. A built-in tile set is used if none is assigned */
+	UPROPERTY(EditAnywhere, Category = Paint)
+	UHasteBlueNoiseTiles* BlueNoiseTiles;
+
+	/** Size of the square area around the cursor that is filled by the Fill button */
+	UPROPERTY(EditAnywhere, Category = Fill, meta = (ClampMin = "1"))
+	float FillAreaSize;
+
+	/** Filled areas are recorded in cells of this size, and a cell is regenerated as a whole when its rules or surface change */
+	UPROPERTY(EditAnywhere, Category = Fill, meta = (ClampMin = "100"))
+	float ScatterCellSize;
+
+	/** Regenerate the filled cells as soon as a rule changes */
+	UPROPERTY(EditAnywhere, Category = Fill)
+	bool bUpdateScatterOnChange;
+
+	/** Discard placements that would interpenetrate meshes that were already placed with Haste */
+	UPROPERTY(EditAnywhere, Category = Overlap)
+	bool bRejectOverlaps;
+
+	/** The shape used to approximate the meshes when testing for overlaps */
+	UPROPERTY(EditAnywhere, Category = Overlap)
+	EHasteBoundsShape OverlapShape;
+
+	/** Scales the overlap shapes. Values below 1 allow the meshes to slightly interpenetrate */
+	UPROPERTY(EditAnywhere, Category = Overlap, meta = (ClampMin = "0.01"))
+	float OverlapBoundsScale;
+
+	/** Scales the paint and fill density. Black areas of the texture get no meshes */
+	UPROPERTY(EditAnywhere, Category = DensityMask)
+	UTexture2D* DensityMaskTexture;
+
+	/** The texture channel used as density */
+	UPROPERTY(EditAnywhere, Category = DensityMask)
+	EHasteMaskChannel DensityMaskChannel;
+
+	/** World space rectangle covered by the density mask texture */
+	UPROPERTY(EditAnywhere, Category = DensityMask)
+	FVector2D DensityMaskOrigin;
+
+	UPROPERTY(EditAnywhere, Category = DensityMask)
+	FVector2D DensityMaskSize;
+
+	/** Landscape paint layer used as the density mask when no texture is set */
+	UPROPERTY(EditAnywhere, Category = DensityMask)
+	ULandscapeLayerInfoObject* DensityMaskLayer;
+
+	/** Placements of the same mesh whose pivots are closer than this are considered duplicates */
+	UPROPERTY(EditAnywhere, Category = Cleanup, meta = (ClampMin = "0"))
+	float DuplicatePositionTolerance;
+
+	/** Maximum angle, in degrees, between the rotations of duplicate placements */
+	UPROPERTY(EditAnywhere, Category = Cleanup, meta = (ClampMin = "0", ClampMax = "180"))
+	float DuplicateRotationTolerance;
+
+	/** Maximum scale difference of duplicate placements, relative to their scale */
+	UPROPERTY(EditAnywhere, Category = Cleanup, meta = (ClampMin = "0"))
+	float DuplicateScaleTolerance;
+
+	/** Also remove smaller copies of a mesh that are hidden inside a larger copy at the same spot */
+	UPROPERTY(EditAnywhere, Category = Cleanup)
+	bool bRemoveNestedDuplicates;
 };
@@ -49,6 +49,53 @@ void SHasteEditor::Construct(const FArguments& InArgs)
 	[
 		SNew(SVerticalBox)
 
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(2.0f)
+		[
+			SNew(SWrapBox)
+			.UseAllottedWidth(true)
+
+			+ SWrapBox::Slot()
+			.Padding(2.0f)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("ApplyCullDistances", "Apply Cull Distances"))
+				.ToolTipText(LOCTEXT("ApplyCullDistancesTooltip", "Re-applies the project wide cull distance rule to every mesh placed by Haste in the level"))
+				.OnClicked(this, &SHasteEditor::OnApplyCullDistancesClicked)
+			]
+
+			+ SWrapBox::Slot()
+			.Padding(2.0f)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("Fill", "Fill Around Cursor"))
+				.ToolTipText(LOCTEXT("FillTooltip", "Scatters the selected meshes over the fill area around the last cursor location. The meshes are added as instances over several frames"))
+				.OnClicked(this, &SHasteEditor::OnFillClicked)
+				.IsEnabled(this, &SHasteEditor::IsFillEnabled)
+			]
+
+			+ SWrapBox::Slot()
+			.Padding(2.0f)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("UpdateScatter", "Update Scatter"))
+				.ToolTipText(LOCTEXT("UpdateScatterTooltip", "Regenerates the filled areas whose rules or underlying surface changed since they were filled"))
+				.OnClicked(this, &SHasteEditor::OnUpdateScatterClicked)
+				.IsEnabled(this, &SHasteEditor::IsFillEnabled)
+			]
+
+			+ SWrapBox::Slot()
+			.Padding(2.0f)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("RemoveDuplicates", "Remove Duplicates"))
+				.ToolTipText(LOCTEXT("RemoveDuplicatesTooltip", "Removes the meshes placed by Haste that duplicate another placement of the same mesh, within the cleanup tolerances"))
+				.OnClicked(this, &SHasteEditor::OnRemoveDuplicatesClicked)
+				.IsEnabled(this, &SHasteEditor::IsFillEnabled)
+			]
+		]
+
 		+ SVerticalBox::Slot()
 		.AutoHeight()
 		[
@@ -57,6 +104,44 @@ void SHasteEditor::Construct(const FArguments& InArgs)
 	];
 }
 
+FReply SHasteEditor::OnApplyCullDistancesClicked()
+{
+	if (FEdModeHaste* HasteMode = static_cast<FEdModeHaste*>(GLevelEditorModeTools().GetActiveMode(FEdModeHaste::EM_Haste))) {
+		HasteMode->ApplyCullDistancesToLevel();
+	}
+	return FReply::Handled();
+}
+
+FReply SHasteEditor::OnFillClicked()
+{
+	if (FEdModeHaste* HasteMode = static_cast<FEdModeHaste*>(GLevelEditorModeTools().GetActiveMode(FEdModeHaste::EM_Haste))) {
+		HasteMode->FillAroundCursor();
+	}
+	return FReply::Handled();
+}
+
+FReply SHasteEditor::OnUpdateScatterClicked()
+{
+	if (FEdModeHaste* HasteMode = static_cast<FEdModeHaste*>(GLevelEditorModeTools().GetActiveMode(FEdModeHaste::EM_Haste))) {
+		HasteMode->UpdateScatter();
+	}
+	return FReply::Handled();
+}
+
+FReply SHasteEditor::OnRemoveDuplicatesClicked()
+{
+	if (FEdModeHaste* HasteMode = static_cast<FEdModeHaste*>(GLevelEditorModeTools().GetActiveMode(FEdModeHaste::EM_Haste))) {
+		HasteMode->RemoveDuplicatesInLevel();
+	}
+	return FReply::Handled();
+}
+
+bool SHasteEditor::IsFillEnabled() const
+{
+	FEdModeHaste* HasteMode = static_cast<FEdModeHaste*>(GLevelEditorModeTools().GetActiveMode(FEdModeHaste::EM_Haste));
+	return HasteMode && !HasteMode->IsPlacementJobRunning();
+}
+
 void SHasteEditor::SetSettingsObject(UObject* Object, bool bForceRefresh /*= false*/)
 {
 	if (DetailsPanel.IsValid()) {
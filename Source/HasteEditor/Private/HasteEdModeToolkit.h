@@ -37,6 +37,13 @@ public:
 	
 	void SetSettingsObject(UObject* Object, bool bForceRefresh = false);
 
+private:
+	FReply OnApplyCullDistancesClicked();
+	FReply OnFillClicked();
+	FReply OnUpdateScatterClicked();
+	FReply OnRemoveDuplicatesClicked();
+	bool IsFillEnabled() const;
+
 private:
 	TSharedPtr<class IDetailsView> DetailsPanel;
 
@@ -9,6 +9,8 @@
 
 #include "ModuleManager.h"
 #include "HasteEdMode.h"
+#include "Placement/HasteMeshMetadata.h"
+#include "Placement/HastePlacementJournal.h"
 
 #define LOCTEXT_NAMESPACE "HasteEditorModule" 
 
@@ -22,11 +24,15 @@ class FHasteEditorModule : public IHasteEditorModule
 			FSlateIcon(FEditorStyle::GetStyleSetName(), "LevelEditor.FoliageMode", "LevelEditor.FoliageMode.Small"),
 			true, 400
 		);
+		FHasteMeshMetadataCache::Initialize();
+		FHastePlacementJournal::Initialize();
 	}
 
 
 	virtual void ShutdownModule() override {
 		FEditorModeRegistry::Get().UnregisterMode(FEdModeHaste::EM_Haste);
+		FHastePlacementJournal::Shutdown();
+		FHasteMeshMetadataCache::Shutdown();
 	}
 };
 
@@ -0,0 +1,13 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteProjectSettings.h"
+
+UHasteProjectSettings::UHasteProjectSettings(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	bApplyCullDistanceOnPlacement = true;
+	CullScreenSize = 0.01f;
+	MinCullDistance = 1000.0f;
+	MaxCullDistance = 0.0f;
+	PlacementCommitBudget = 10.0f;
+}
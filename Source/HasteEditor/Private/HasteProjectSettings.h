@@ -0,0 +1,36 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "Engine/DeveloperSettings.h"
+#include "HasteProjectSettings.generated.h"
+
+/**
+ * Project wide Haste settings, shared by everyone working on the project
+ */
+UCLASS(config = Editor, defaultconfig, meta = (DisplayName = "Haste"))
+class UHasteProjectSettings : public UDeveloperSettings {
+	GENERATED_UCLASS_BODY()
+
+public:
+	/** Set the cull distance of the placed meshes from their bounds, when they are placed */
+	UPROPERTY(config, EditAnywhere, Category = Culling)
+	bool bApplyCullDistanceOnPlacement;
+
+	/**
+	 * Meshes are culled once their bounds get smaller than this screen size. Uses the same convention as
+	 * the LOD screen sizes of static meshes (bounds diameter over screen width), with a 90 degree field of view
+	 */
+	UPROPERTY(config, EditAnywhere, Category = Culling, meta = (ClampMin = "0.0001", ClampMax = "1"))
+	float CullScreenSize;
+
+	/** Meshes are never culled closer than this distance */
+	UPROPERTY(config, EditAnywhere, Category = Culling, meta = (ClampMin = "0"))
+	float MinCullDistance;
+
+	/** Meshes are always culled beyond this distance. Zero means there is no upper limit */
+	UPROPERTY(config, EditAnywhere, Category = Culling, meta = (ClampMin = "0"))
+	float MaxCullDistance;
+
+	/** Time in milliseconds spent every frame adding the results of a bulk placement (e.g. fill) to the level */
+	UPROPERTY(config, EditAnywhere, Category = Performance, meta = (ClampMin = "1", ClampMax = "100"))
+	float PlacementCommitBudget;
+};
@@ -0,0 +1,111 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteCullDistance.h"
+#include "HastePlacement.h"
+#include "HasteProjectSettings.h"
+#include "HasteMeshMetadata.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+float FHasteCullDistance::Compute(UStaticMesh* Mesh, const FVector& Scale3D)
+{
+	const UHasteProjectSettings* Settings = GetDefault<UHasteProjectSettings>();
+	if (!Mesh || Settings->CullScreenSize <= 0) {
+		return 0;
+	}
+
+	// Same convention as the LOD screen sizes (ComputeBoundsScreenSize): the screen size of a sphere is
+	// 2 * Radius * ScreenMultiple / Distance, and the screen multiple of a 90 degree projection is 0.5
+	const float ScreenMultiple = 0.5f;
+	const float Radius = FHasteMeshMetadataCache::Get().Get(Mesh).Bounds.SphereRadius * Scale3D.GetAbsMax();
+	float Distance = FMath::Max(2.0f * Radius * ScreenMultiple / Settings->CullScreenSize, Settings->MinCullDistance);
+	if (Settings->MaxCullDistance > 0) {
+		Distance = FMath::Min(Distance, Settings->MaxCullDistance);
+	}
+	return Distance;
+}
+
+bool FHasteCullDistance::ApplyToComponent(UStaticMeshComponent* Component)
+{
+	if (!Component) {
+		return false;
+	}
+
+	// Instances are culled per instance, using the largest instance so none of them pops out early
+	if (UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component)) {
+		FVector MaxScale(0);
+		for (const FInstancedStaticMeshInstanceData& Instance : InstancedComponent->PerInstanceSMData) {
+			MaxScale = MaxScale.ComponentMax(FTransform(Instance.Transform).GetScale3D().GetAbs());
+		}
+		const int32 EndCullDistance = FMath::RoundToInt(Compute(InstancedComponent->GetStaticMesh(), MaxScale * InstancedComponent->GetComponentScale()));
+		if (InstancedComponent->InstanceEndCullDistance == EndCullDistance) {
+			return false;
+		}
+
+		InstancedComponent->Modify();
+		InstancedComponent->InstanceEndCullDistance = EndCullDistance;
+		InstancedComponent->InstanceStartCullDistance = FMath::RoundToInt(EndCullDistance * 0.9f);
+		InstancedComponent->MarkRenderStateDirty();
+		return true;
+	}
+
+	const float CullDistance = Compute(Component->GetStaticMesh(), Component->GetComponentScale());
+	if (FMath::IsNearlyEqual(Component->LDMaxDrawDistance, CullDistance)) {
+		return false;
+	}
+
+	Component->Modify();
+	Component->LDMaxDrawDistance = CullDistance;
+	Component->MarkRenderStateDirty();
+	return true;
+}
+
+bool FHasteCullDistance::ApplyToNewInstances(UInstancedStaticMeshComponent* Component, int32 FirstNewInstance, const TArray<FTransform>& WorldTransforms)
+{
+	if (!Component) {
+		return false;
+	}
+	if (FirstNewInstance > 0 && Component->InstanceEndCullDistance <= 0) {
+		return ApplyToComponent(Component);
+	}
+
+	// The distance only grows with the scale, so the largest new instance decides if the component has to change
+	FVector MaxScale(0);
+	for (const FTransform& WorldTransform : WorldTransforms) {
+		MaxScale = MaxScale.ComponentMax(WorldTransform.GetScale3D().GetAbs());
+	}
+	const int32 EndCullDistance = FMath::RoundToInt(Compute(Component->GetStaticMesh(), MaxScale));
+	const int32 CurrentDistance = Component->InstanceEndCullDistance;
+	if (FirstNewInstance > 0 ? EndCullDistance <= CurrentDistance : EndCullDistance == CurrentDistance) {
+		return false;
+	}
+
+	Component->Modify();
+	Component->InstanceEndCullDistance = EndCullDistance;
+	Component->InstanceStartCullDistance = FMath::RoundToInt(EndCullDistance * 0.9f);
+	Component->MarkRenderStateDirty();
+	return true;
+}
+
+int32 FHasteCullDistance::ApplyToWorld(UWorld* World)
+{
+	int32 NumModified = 0;
+	if (!World) {
+		return NumModified;
+	}
+
+	for (TActorIterator<AActor> It(World); It; ++It) {
+		AActor* Actor = *It;
+		if (!Actor || !Actor->ActorHasTag(FHasteTags::PlacedActor)) {
+			continue;
+		}
+
+		TInlineComponentArray<UStaticMeshComponent*> Components;
+		Actor->GetComponents(Components);
+		for (UStaticMeshComponent* Component : Components) {
+			if (ApplyToComponent(Component)) {
+				NumModified++;
+			}
+		}
+	}
+	return NumModified;
+}
@@ -0,0 +1,24 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+
+/**
+ * Derives the cull distance of placed meshes from their bounds and the project wide screen size rule
+ */
+class FHasteCullDistance
+{
+public:
+	/** Distance at which a mesh with the given scale shrinks below the culling screen size */
+	static float Compute(UStaticMesh* Mesh, const FVector& Scale3D);
+
+	/** Applies the culling rule to the component. Returns true if the component was modified */
+	static bool ApplyToComponent(UStaticMeshComponent* Component);
+
+	/**
+	 * Folds instances that were just added into the cull distance of the component, without visiting the older instances.
+	 * Falls back to ApplyToComponent if the older instances were never evaluated. Returns true if the component was modified
+	 */
+	static bool ApplyToNewInstances(UInstancedStaticMeshComponent* Component, int32 FirstNewInstance, const TArray<FTransform>& WorldTransforms);
+
+	/** Re-applies the culling rule to every mesh placed by Haste in the world. Returns the number of modified components */
+	static int32 ApplyToWorld(UWorld* World);
+};
@@ -0,0 +1,102 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteDeferredInvalidation.h"
+#include "AI/Navigation/NavigationSystem.h"
+
+FHasteDeferredInvalidation::FHasteDeferredInvalidation()
+	: bStrokeActive(false)
+{
+}
+
+FHasteDeferredInvalidation::~FHasteDeferredInvalidation()
+{
+	EndStroke();
+}
+
+void FHasteDeferredInvalidation::BeginStroke(UWorld* InWorld)
+{
+	if (bStrokeActive) {
+		EndStroke();
+	}
+
+	bStrokeActive = true;
+	World = InWorld;
+
+	// Hold back the navigation octree updates of the placed actors until the stroke ends
+	NavigationLock.Reset(new FNavigationLockContext(InWorld, ENavigationLockReason::ContinuousEditorMove));
+}
+
+void FHasteDeferredInvalidation::AddPlacedActor(AActor* Actor, const FString& Label)
+{
+	if (!Actor) {
+		return;
+	}
+
+	DirtyLevels.AddUnique(Actor->GetLevel());
+
+	FPendingLabel PendingLabel;
+	PendingLabel.Actor = Actor;
+	PendingLabel.Label = Label;
+	PendingLabels.Add(PendingLabel);
+}
+
+void FHasteDeferredInvalidation::AddDirtyLevel(ULevel* Level)
+{
+	DirtyLevels.AddUnique(Level);
+}
+
+void FHasteDeferredInvalidation::EndStroke()
+{
+	if (!bStrokeActive) {
+		return;
+	}
+	bStrokeActive = false;
+
+	// Releasing the lock applies the held back octree updates, which dirty the bounds of each placement.
+	// Instanced components accumulate the bounds of their new instances and dirty them once as well.
+	// No union of the stroke is added on top, it would only rebuild the empty tiles between the placements
+	NavigationLock.Reset();
+
+	UWorld* StrokeWorld = World.Get();
+	if (StrokeWorld && PendingLabels.Num() > 0) {
+		AssignLabels(StrokeWorld);
+	}
+
+	for (const TWeakObjectPtr<ULevel>& Level : DirtyLevels) {
+		if (Level.IsValid()) {
+			Level->MarkPackageDirty();
+		}
+	}
+
+	// The outliner already queues the add notification of every spawned actor and applies them in one update,
+	// so no full refresh of the actor list is requested here
+	PendingLabels.Reset();
+	DirtyLevels.Reset();
+	World.Reset();
+}
+
+void FHasteDeferredInvalidation::AssignLabels(UWorld* InWorld)
+{
+	// Collect the labels in use once, instead of searching the level for every placed actor
+	TSet<FString> UsedLabels;
+	for (TActorIterator<AActor> It(InWorld); It; ++It) {
+		UsedLabels.Add(It->GetActorLabel());
+	}
+
+	TMap<FString, int32> NextLabelIndex;
+	for (const FPendingLabel& PendingLabel : PendingLabels) {
+		AActor* Actor = PendingLabel.Actor.Get();
+		if (!Actor) continue;
+
+		FString Label = PendingLabel.Label;
+		if (UsedLabels.Contains(Label)) {
+			int32& LabelIndex = NextLabelIndex.FindOrAdd(PendingLabel.Label);
+			do {
+				Label = FString::Printf(TEXT("%s%d"), *PendingLabel.Label, ++LabelIndex);
+			} while (UsedLabels.Contains(Label));
+		}
+
+		UsedLabels.Add(Label);
+		Actor->SetActorLabel(Label);
+	}
+}
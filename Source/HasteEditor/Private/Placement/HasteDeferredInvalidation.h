@@ -0,0 +1,44 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+
+struct FNavigationLockContext;
+
+/**
+ * Defers the editor side effects of placing meshes until the end of a stroke.
+ * Navigation octree updates are locked for the duration of the stroke and applied together when it ends,
+ * each placement dirtying only its own bounds. Actor labels are made unique in a single pass over the level,
+ * and every touched package is marked dirty once
+ */
+class FHasteDeferredInvalidation
+{
+public:
+	FHasteDeferredInvalidation();
+	~FHasteDeferredInvalidation();
+
+	void BeginStroke(UWorld* InWorld);
+	void EndStroke();
+	bool IsStrokeActive() const { return bStrokeActive; }
+
+	/** Records an actor placed during the stroke. Its label is assigned when the stroke ends */
+	void AddPlacedActor(AActor* Actor, const FString& Label);
+
+	/** Records a level that received content during the stroke that is not an actor of its own, like instances */
+	void AddDirtyLevel(ULevel* Level);
+
+private:
+	/** Gives every pending actor a label that is unique within the world */
+	void AssignLabels(UWorld* InWorld);
+
+private:
+	bool bStrokeActive;
+	TWeakObjectPtr<UWorld> World;
+	TUniquePtr<FNavigationLockContext> NavigationLock;
+
+	struct FPendingLabel
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FString Label;
+	};
+	TArray<FPendingLabel> PendingLabels;
+	TArray<TWeakObjectPtr<ULevel>> DirtyLevels;
+};
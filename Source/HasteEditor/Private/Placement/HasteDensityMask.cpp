@@ -0,0 +1,156 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteDensityMask.h"
+#include "LandscapeInfo.h"
+#include "LandscapeEdit.h"
+#include "Landscape.h"
+
+bool FHasteDensityMask::BuildFromTexture(UTexture2D* Texture, int32 Channel, const FBox2D& WorldBounds)
+{
+	Mips.Reset();
+	if (!Texture || !WorldBounds.bIsValid) {
+		return false;
+	}
+
+	const int32 SizeX = Texture->Source.GetSizeX();
+	const int32 SizeY = Texture->Source.GetSizeY();
+	const ETextureSourceFormat Format = Texture->Source.GetFormat();
+	TArray<uint8> RawData;
+	if (SizeX <= 0 || SizeY <= 0 || !Texture->Source.GetMipData(RawData, 0)) {
+		return false;
+	}
+
+	// Byte offset of the channel within a texel, and the size of a texel
+	int32 ChannelOffset = 0;
+	int32 TexelSize = 0;
+	switch (Format) {
+	case TSF_G8:
+		TexelSize = 1;
+		break;
+	case TSF_BGRA8:
+	{
+		// Stored as B, G, R, A
+		static const int32 Offsets[] = { 2, 1, 0, 3 };
+		TexelSize = 4;
+		ChannelOffset = Offsets[FMath::Clamp(Channel, 0, 3)];
+		break;
+	}
+	case TSF_RGBA16:
+		// Use the high byte of the 16 bit channel
+		TexelSize = 8;
+		ChannelOffset = FMath::Clamp(Channel, 0, 3) * 2 + 1;
+		break;
+	default:
+		// Floating point and HDR sources are not meant to be masks
+		return false;
+	}
+	if (RawData.Num() < SizeX * SizeY * TexelSize) {
+		return false;
+	}
+
+	FMaskMip Mip;
+	Mip.SizeX = SizeX;
+	Mip.SizeY = SizeY;
+	Mip.Values.SetNumUninitialized(SizeX * SizeY);
+	for (int32 Index = 0; Index < SizeX * SizeY; Index++) {
+		Mip.Values[Index] = RawData[Index * TexelSize + ChannelOffset];
+	}
+	Mips.Add(MoveTemp(Mip));
+
+	const FVector2D WorldSize = WorldBounds.GetSize();
+	const FVector Scale(SizeX / WorldSize.X, SizeY / WorldSize.Y, 1);
+	WorldToTexel = FTransform(FQuat::Identity, -FVector(WorldBounds.Min, 0) * Scale, Scale);
+	TexelsPerUnit = FMath::Max(Scale.X, Scale.Y);
+
+	BuildMips();
+	return true;
+}
+
+bool FHasteDensityMask::BuildFromLandscapeLayer(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo)
+{
+	Mips.Reset();
+	ALandscapeProxy* Landscape = LandscapeInfo ? LandscapeInfo->GetLandscapeProxy() : nullptr;
+	int32 MinX, MinY, MaxX, MaxY;
+	if (!Landscape || !LayerInfo || !LandscapeInfo->GetLandscapeExtent(MinX, MinY, MaxX, MaxY)) {
+		return false;
+	}
+
+	FMaskMip Mip;
+	Mip.SizeX = MaxX - MinX + 1;
+	Mip.SizeY = MaxY - MinY + 1;
+	Mip.Values.SetNumZeroed(Mip.SizeX * Mip.SizeY);
+	FLandscapeEditDataInterface LandscapeEdit(LandscapeInfo);
+	LandscapeEdit.GetWeightDataFast(LayerInfo, MinX, MinY, MaxX, MaxY, Mip.Values.GetData(), 0);
+	Mips.Add(MoveTemp(Mip));
+
+	// Landscape vertices sit on texel centers
+	const FTransform LandscapeToWorld = Landscape->LandscapeActorToWorld();
+	WorldToTexel = LandscapeToWorld.Inverse() * FTransform(FVector(0.5f - MinX, 0.5f - MinY, 0));
+	TexelsPerUnit = 1.0f / LandscapeToWorld.GetScale3D().GetAbsMax();
+
+	BuildMips();
+	return true;
+}
+
+void FHasteDensityMask::BuildMips()
+{
+	while (Mips.Last().SizeX > 1 || Mips.Last().SizeY > 1) {
+		const FMaskMip& Source = Mips.Last();
+		FMaskMip Mip;
+		Mip.SizeX = FMath::Max(Source.SizeX / 2, 1);
+		Mip.SizeY = FMath::Max(Source.SizeY / 2, 1);
+		Mip.Values.SetNumUninitialized(Mip.SizeX * Mip.SizeY);
+		for (int32 Y = 0; Y < Mip.SizeY; Y++) {
+			const int32 Y0 = FMath::Min(Y * 2, Source.SizeY - 1);
+			const int32 Y1 = FMath::Min(Y * 2 + 1, Source.SizeY - 1);
+			for (int32 X = 0; X < Mip.SizeX; X++) {
+				const int32 X0 = FMath::Min(X * 2, Source.SizeX - 1);
+				const int32 X1 = FMath::Min(X * 2 + 1, Source.SizeX - 1);
+				const int32 Sum = Source.Values[Y0 * Source.SizeX + X0] + Source.Values[Y0 * Source.SizeX + X1]
+					+ Source.Values[Y1 * Source.SizeX + X0] + Source.Values[Y1 * Source.SizeX + X1];
+				Mip.Values[Y * Mip.SizeX + X] = uint8((Sum + 2) / 4);
+			}
+		}
+		// Add after reading, as the add may reallocate the source
+		Mips.Add(MoveTemp(Mip));
+	}
+}
+
+float FHasteDensityMask::SampleMip(int32 MipIndex, float TexelX, float TexelY) const
+{
+	const FMaskMip& Mip = Mips[MipIndex];
+
+	// Texel centers are at half texel offsets
+	const float X = FMath::Clamp(TexelX - 0.5f, 0.0f, float(Mip.SizeX - 1));
+	const float Y = FMath::Clamp(TexelY - 0.5f, 0.0f, float(Mip.SizeY - 1));
+	const int32 X0 = FMath::FloorToInt(X);
+	const int32 Y0 = FMath::FloorToInt(Y);
+	const int32 X1 = FMath::Min(X0 + 1, Mip.SizeX - 1);
+	const int32 Y1 = FMath::Min(Y0 + 1, Mip.SizeY - 1);
+	const float FracX = X - X0;
+	const float FracY = Y - Y0;
+
+	const float V00 = Mip.Values[Y0 * Mip.SizeX + X0];
+	const float V10 = Mip.Values[Y0 * Mip.SizeX + X1];
+	const float V01 = Mip.Values[Y1 * Mip.SizeX + X0];
+	const float V11 = Mip.Values[Y1 * Mip.SizeX + X1];
+	return FMath::Lerp(FMath::Lerp(V00, V10, FracX), FMath::Lerp(V01, V11, FracX), FracY) / 255.0f;
+}
+
+float FHasteDensityMask::Sample(const FVector& WorldLocation, float Footprint) const
+{
+	if (!IsValid()) {
+		return 1.0f;
+	}
+
+	const FVector Texel = WorldToTexel.TransformPosition(WorldLocation);
+	const FMaskMip& BaseMip = Mips[0];
+	if (Texel.X < 0 || Texel.Y < 0 || Texel.X > BaseMip.SizeX || Texel.Y > BaseMip.SizeY) {
+		return 1.0f;
+	}
+
+	const float FootprintTexels = Footprint * TexelsPerUnit;
+	const int32 MipIndex = FootprintTexels > 1.0f ? FMath::Min(int32(FMath::FloorLog2(uint32(FootprintTexels))), Mips.Num() - 1) : 0;
+	const float MipScale = 1.0f / (1 << MipIndex);
+	return SampleMip(MipIndex, Texel.X * MipScale, Texel.Y * MipScale);
+}
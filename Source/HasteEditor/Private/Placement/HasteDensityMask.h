@@ -0,0 +1,49 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+
+class ULandscapeInfo;
+class ULandscapeLayerInfoObject;
+
+/**
+ * CPU copy of a density mask (a texture channel or a landscape paint layer) with a mip chain, so any number of
+ * placement candidates can be tested against it from any thread without touching the render thread.
+ * Outside of the masked area the density is left unchanged
+ */
+class FHasteDensityMask
+{
+public:
+	/** Decodes a channel of the texture's source art. The texture covers the world space rectangle */
+	bool BuildFromTexture(UTexture2D* Texture, int32 Channel, const FBox2D& WorldBounds);
+
+	/** Reads the weights of the paint layer over the whole landscape */
+	bool BuildFromLandscapeLayer(ULandscapeInfo* LandscapeInfo, ULandscapeLayerInfoObject* LayerInfo);
+
+	bool IsValid() const { return Mips.Num() > 0; }
+
+	/**
+	 * Bilinear density in [0, 1] at the world location. The mip is chosen so one texel covers about the
+	 * footprint of a single sample, in world units
+	 */
+	float Sample(const FVector& WorldLocation, float Footprint) const;
+
+private:
+	/** Fills the mip chain below mip 0 with 2x2 box filtered averages */
+	void BuildMips();
+
+	float SampleMip(int32 MipIndex, float TexelX, float TexelY) const;
+
+private:
+	struct FMaskMip
+	{
+		int32 SizeX;
+		int32 SizeY;
+		TArray<uint8> Values;
+	};
+	TArray<FMaskMip> Mips;
+
+	/** Maps world space to the texel space of the first mip */
+	FTransform WorldToTexel;
+
+	/** Mip 0 texels per world unit, used to pick the mip from a footprint */
+	float TexelsPerUnit;
+};
@@ -0,0 +1,249 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteDuplicateScan.h"
+#include "HastePlacement.h"
+#include "HasteInstanceContainer.h"
+#include "HasteMeshMetadata.h"
+#include "HastePlacementJournal.h"
+#include "ParallelFor.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
+/** Smallest grid cell used by the scan, so an exact match tolerance does not create a cell per placement */
+#define HASTE_DUPLICATE_MIN_CELL_SIZE 0.1f
+
+namespace
+{
+	/** Where a scanned placement came from: a placed actor, or an instance of a Haste container component */
+	struct FScanSource
+	{
+		AActor* Actor;
+		UHierarchicalInstancedStaticMeshComponent* Component;
+	};
+
+	struct FScanEntry
+	{
+		FVector Location;
+		FQuat Rotation;
+		FVector Scale;
+		int32 Source;
+		int32 InstanceIndex;
+	};
+
+	enum class EScanVerdict : uint8
+	{
+		Keep,
+		Duplicate,
+		Nested
+	};
+
+	FBox ScaleBox(const FBox& Box, const FVector& Scale)
+	{
+		FBox Result(0);
+		Result += Box.Min * Scale;
+		Result += Box.Max * Scale;
+		return Result;
+	}
+
+	FIntVector GetCell(const FVector& Location, float CellSize)
+	{
+		return FIntVector(
+			FMath::FloorToInt(Location.X / CellSize),
+			FMath::FloorToInt(Location.Y / CellSize),
+			FMath::FloorToInt(Location.Z / CellSize));
+	}
+
+	/** Judges the placements of a single mesh. Larger copies are visited first, so a nested copy always finds its container */
+	void ScanMesh(const TArray<FScanEntry>& Entries, const TArray<int32>& MeshEntries, const FBox& MeshBox,
+		const FHasteDuplicateTolerance& Tolerance, TArray<EScanVerdict>& Verdicts)
+	{
+		TArray<int32> Order = MeshEntries;
+		Order.Sort([&Entries](int32 A, int32 B) {
+			const float ScaleA = Entries[A].Scale.GetAbsMax();
+			const float ScaleB = Entries[B].Scale.GetAbsMax();
+			return ScaleA > ScaleB || (ScaleA == ScaleB && A < B);
+		});
+
+		const float CellSize = FMath::Max(Tolerance.Position, HASTE_DUPLICATE_MIN_CELL_SIZE);
+		const float PositionToleranceSq = FMath::Square(Tolerance.Position);
+
+		// Two rotations are within the angle when the dot product of their quaternions is above the cosine of half the angle
+		const float MinRotationDot = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(Tolerance.RotationDegrees, 0.0f, 180.0f)) * 0.5f);
+
+		// The kept placements are linked per cell: the map holds the last one added, and Next the one before it
+		TMap<FIntVector, int32> CellHeads;
+		CellHeads.Reserve(Order.Num());
+		TArray<int32> Next;
+		Next.Init(INDEX_NONE, Order.Num());
+		TArray<int32> Kept;
+		Kept.Reserve(Order.Num());
+
+		for (int32 EntryIndex : Order) {
+			const FScanEntry& Entry = Entries[EntryIndex];
+			const FIntVector Cell = GetCell(Entry.Location, CellSize);
+
+			EScanVerdict Verdict = EScanVerdict::Keep;
+			for (int32 X = -1; X <= 1 && Verdict == EScanVerdict::Keep; X++) {
+				for (int32 Y = -1; Y <= 1 && Verdict == EScanVerdict::Keep; Y++) {
+					for (int32 Z = -1; Z <= 1 && Verdict == EScanVerdict::Keep; Z++) {
+						const int32* Head = CellHeads.Find(Cell + FIntVector(X, Y, Z));
+						for (int32 KeptSlot = Head ? *Head : INDEX_NONE; KeptSlot != INDEX_NONE; KeptSlot = Next[KeptSlot]) {
+							const FScanEntry& Other = Entries[Kept[KeptSlot]];
+							if (FVector::DistSquared(Entry.Location, Other.Location) > PositionToleranceSq
+								|| FMath::Abs(Entry.Rotation | Other.Rotation) < MinRotationDot) {
+								continue;
+							}
+
+							if ((Entry.Scale - Other.Scale).GetAbs().GetMax() <= Tolerance.Scale * Other.Scale.GetAbsMax()) {
+								Verdict = EScanVerdict::Duplicate;
+								break;
+							}
+
+							// A smaller copy is hidden if its bounds fit inside the larger copy, measured in the frame of the larger copy
+							if (Tolerance.bIncludeNested) {
+								const FVector Offset = Other.Rotation.UnrotateVector(Entry.Location - Other.Location);
+								if (ScaleBox(MeshBox, Other.Scale).IsInside(ScaleBox(MeshBox, Entry.Scale).ShiftBy(Offset))) {
+									Verdict = EScanVerdict::Nested;
+									break;
+								}
+							}
+						}
+					}
+				}
+			}
+
+			Verdicts[EntryIndex] = Verdict;
+			if (Verdict == EScanVerdict::Keep) {
+				const int32 KeptSlot = Kept.Add(EntryIndex);
+				int32& Head = CellHeads.FindOrAdd(Cell, INDEX_NONE);
+				Next[KeptSlot] = Head;
+				Head = KeptSlot;
+			}
+		}
+	}
+}
+
+FHasteDuplicateTolerance::FHasteDuplicateTolerance()
+	: Position(1.0f)
+	, RotationDegrees(1.0f)
+	, Scale(0.01f)
+	, bIncludeNested(true)
+{
+}
+
+FHasteDuplicateScanResult::FHasteDuplicateScanResult()
+	: NumDuplicates(0)
+	, NumNested(0)
+{
+}
+
+void FHasteDuplicateScan::Scan(UWorld* World, const FHasteDuplicateTolerance& Tolerance, FHasteMeshMetadataCache& MetadataCache, FHasteDuplicateScanResult& OutResult)
+{
+	OutResult = FHasteDuplicateScanResult();
+	if (!World) {
+		return;
+	}
+
+	// Flatten every placement into one array, grouped by mesh
+	TArray<FScanSource> Sources;
+	TArray<FScanEntry> Entries;
+	TMap<UStaticMesh*, int32> MeshGroups;
+	TArray<TArray<int32>> GroupEntries;
+	TArray<FBox> GroupBounds;
+
+	auto AddEntry = [&](UStaticMesh* Mesh, const FTransform& Transform, int32 Source, int32 InstanceIndex) {
+		int32* Group = MeshGroups.Find(Mesh);
+		if (!Group) {
+			Group = &MeshGroups.Add(Mesh, GroupEntries.Num());
+			GroupEntries.AddDefaulted();
+			GroupBounds.Add(MetadataCache.Get(Mesh).Bounds.GetBox());
+		}
+
+		FScanEntry& Entry = Entries[Entries.AddUninitialized()];
+		Entry.Location = Transform.GetLocation();
+		Entry.Rotation = Transform.GetRotation();
+		Entry.Scale = Transform.GetScale3D();
+		Entry.Source = Source;
+		Entry.InstanceIndex = InstanceIndex;
+		GroupEntries[*Group].Add(Entries.Num() - 1);
+	};
+
+	for (TActorIterator<AActor> It(World); It; ++It) {
+		AActor* Actor = *It;
+		if (!Actor || !Actor->ActorHasTag(FHasteTags::PlacedActor)) {
+			continue;
+		}
+
+		if (FHasteInstanceContainers::IsContainer(Actor)) {
+			TInlineComponentArray<UHierarchicalInstancedStaticMeshComponent*> Components;
+			Actor->GetComponents(Components);
+			for (UHierarchicalInstancedStaticMeshComponent* Component : Components) {
+				UStaticMesh* Mesh = Component->GetStaticMesh();
+				if (!Mesh) continue;
+
+				const int32 Source = Sources.Add({ Actor, Component });
+				const FTransform& ComponentToWorld = Component->ComponentToWorld;
+				for (int32 InstanceIndex = 0; InstanceIndex < Component->PerInstanceSMData.Num(); InstanceIndex++) {
+					AddEntry(Mesh, FTransform(Component->PerInstanceSMData[InstanceIndex].Transform) * ComponentToWorld, Source, InstanceIndex);
+				}
+			}
+		}
+		else {
+			// Placed actors hold a single mesh, and are removed as a whole
+			TInlineComponentArray<UStaticMeshComponent*> Components;
+			Actor->GetComponents(Components);
+			if (Components.Num() == 1 && Components[0]->GetStaticMesh()) {
+				const int32 Source = Sources.Add({ Actor, nullptr });
+				AddEntry(Components[0]->GetStaticMesh(), Components[0]->ComponentToWorld, Source, INDEX_NONE);
+			}
+		}
+	}
+
+	TArray<EScanVerdict> Verdicts;
+	Verdicts.SetNumZeroed(Entries.Num());
+	ParallelFor(GroupEntries.Num(), [&](int32 Group) {
+		ScanMesh(Entries, GroupEntries[Group], GroupBounds[Group], Tolerance, Verdicts);
+	});
+
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); EntryIndex++) {
+		const EScanVerdict Verdict = Verdicts[EntryIndex];
+		if (Verdict == EScanVerdict::Keep) continue;
+
+		const FScanEntry& Entry = Entries[EntryIndex];
+		const FScanSource& Source = Sources[Entry.Source];
+		if (Source.Component) {
+			OutResult.Instances.FindOrAdd(Source.Component).Add(Entry.InstanceIndex);
+		}
+		else {
+			OutResult.Actors.Add(Source.Actor);
+		}
+
+		if (Verdict == EScanVerdict::Duplicate) {
+			OutResult.NumDuplicates++;
+		}
+		else {
+			OutResult.NumNested++;
+		}
+	}
+}
+
+int32 FHasteDuplicateScan::Remove(UWorld* World, FHasteDuplicateScanResult& Result)
+{
+	FHastePlacementJournal* Journal = FHastePlacementJournal::Get();
+	int32 NumRemoved = 0;
+	for (auto& Entry : Result.Instances) {
+		UHierarchicalInstancedStaticMeshComponent* Component = Entry.Key;
+		for (int32 InstanceIndex : Entry.Value) {
+			FTransform InstanceTransform;
+			if (Journal && Component->GetInstanceTransform(InstanceIndex, InstanceTransform, true)) {
+				Journal->RecordErase(Component->GetStaticMesh(), InstanceTransform, Component->GetComponentLevel(), true);
+			}
+		}
+		NumRemoved += FHasteInstanceContainers::RemoveInstances(Component, Entry.Value);
+	}
+	for (AActor* Actor : Result.Actors) {
+		if (World && Actor && World->EditorDestroyActor(Actor, true)) {
+			NumRemoved++;
+		}
+	}
+	return NumRemoved;
+}
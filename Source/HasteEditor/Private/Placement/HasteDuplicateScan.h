@@ -0,0 +1,53 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+
+class FHasteMeshMetadataCache;
+class UHierarchicalInstancedStaticMeshComponent;
+
+/** How close two placements of the same mesh have to be to count as duplicates */
+struct FHasteDuplicateTolerance
+{
+	FHasteDuplicateTolerance();
+
+	/** Maximum distance between the pivots */
+	float Position;
+
+	/** Maximum angle between the rotations, in degrees */
+	float RotationDegrees;
+
+	/** Maximum scale difference, relative to the scale of the kept placement */
+	float Scale;
+
+	/** Also find smaller copies of a mesh that are fully inside a larger copy at the same spot */
+	bool bIncludeNested;
+};
+
+/** The placements found by a duplicate scan */
+struct FHasteDuplicateScanResult
+{
+	FHasteDuplicateScanResult();
+
+	/** Placed actors to delete */
+	TArray<AActor*> Actors;
+
+	/** Instances to remove, per instanced component */
+	TMap<UHierarchicalInstancedStaticMeshComponent*, TArray<int32>> Instances;
+
+	int32 NumDuplicates;
+	int32 NumNested;
+};
+
+/**
+ * Finds placements of the same mesh with nearly identical transforms. The placements of each mesh are
+ * hashed into a grid the size of the position tolerance, so every placement is only compared with its
+ * neighbours, and the meshes are scanned in parallel
+ */
+class FHasteDuplicateScan
+{
+public:
+	/** Collects every Haste placement of the world and finds the redundant ones. The first (or largest) copy is kept */
+	static void Scan(UWorld* World, const FHasteDuplicateTolerance& Tolerance, FHasteMeshMetadataCache& MetadataCache, FHasteDuplicateScanResult& OutResult);
+
+	/** Removes the placements found by a scan. Must be called inside a transaction. Returns the number of removed placements */
+	static int32 Remove(UWorld* World, FHasteDuplicateScanResult& Result);
+};
@@ -0,0 +1,145 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteInstanceContainer.h"
+#include "HastePlacement.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
+#define HASTE_CONTAINER_LABEL TEXT("HasteInstances")
+
+/** Removing more than this fraction of the instances rebuilds the component, instead of removing them one by one */
+#define HASTE_BULK_REMOVE_FRACTION 0.25f
+
+bool FHasteInstanceContainers::IsContainer(const AActor* Actor)
+{
+	return Actor && Actor->ActorHasTag(FHasteTags::InstanceContainer);
+}
+
+TArray<AActor*> FHasteInstanceContainers::GetContainers(UWorld* World)
+{
+	TArray<AActor*> Containers;
+	if (World) {
+		for (TActorIterator<AActor> It(World); It; ++It) {
+			if (IsContainer(*It)) {
+				Containers.Add(*It);
+			}
+		}
+	}
+	return Containers;
+}
+
+AActor* FHasteInstanceContainers::FindOrCreateContainer(ULevel* Level)
+{
+	if (!Level) {
+		return nullptr;
+	}
+
+	for (AActor* Actor : Level->Actors) {
+		if (IsContainer(Actor) && !Actor->IsPendingKill()) {
+			return Actor;
+		}
+	}
+
+	UWorld* World = Level->OwningWorld;
+	if (!World) {
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.OverrideLevel = Level;
+	AActor* Container = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+
+	USceneComponent* RootComponent = NewObject<USceneComponent>(Container, TEXT("Root"), RF_Transactional);
+	RootComponent->SetMobility(EComponentMobility::Static);
+	Container->SetRootComponent(RootComponent);
+	Container->AddInstanceComponent(RootComponent);
+	RootComponent->RegisterComponent();
+
+	// The container is also a Haste placement, so its instances are picked up by the overlap filter and culling rules
+	Container->Tags.Add(FHasteTags::InstanceContainer);
+	Container->Tags.Add(FHasteTags::PlacedActor);
+	FActorLabelUtilities::SetActorLabelUnique(Container, HASTE_CONTAINER_LABEL);
+	return Container;
+}
+
+UHierarchicalInstancedStaticMeshComponent* FHasteInstanceContainers::FindOrCreateComponent(AActor* Container, UStaticMesh* Mesh, bool bScatter)
+{
+	if (!Container || !Mesh) {
+		return nullptr;
+	}
+
+	TInlineComponentArray<UHierarchicalInstancedStaticMeshComponent*> Components;
+	Container->GetComponents(Components);
+	for (UHierarchicalInstancedStaticMeshComponent* Component : Components) {
+		if (Component->GetStaticMesh() == Mesh && Component->ComponentHasTag(FHasteTags::ScatterComponent) == bScatter) {
+			return Component;
+		}
+	}
+
+	Container->Modify();
+	UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(Container, NAME_None, RF_Transactional);
+	Component->SetMobility(EComponentMobility::Static);
+	Component->SetStaticMesh(Mesh);
+	if (bScatter) {
+		Component->ComponentTags.Add(FHasteTags::ScatterComponent);
+	}
+	Component->SetupAttachment(Container->GetRootComponent());
+	Container->AddInstanceComponent(Component);
+	Component->RegisterComponent();
+	return Component;
+}
+
+int32 FHasteInstanceContainers::AddInstances(UHierarchicalInstancedStaticMeshComponent* Component, const TArray<FTransform>& WorldTransforms)
+{
+	if (!Component) {
+		return INDEX_NONE;
+	}
+
+	Component->Modify();
+	const int32 FirstIndex = Component->GetInstanceCount();
+	for (const FTransform& WorldTransform : WorldTransforms) {
+		Component->AddInstanceWorldSpace(WorldTransform);
+	}
+	return FirstIndex;
+}
+
+int32 FHasteInstanceContainers::RemoveInstances(UHierarchicalInstancedStaticMeshComponent* Component, TArray<int32>& InstanceIndices)
+{
+	if (!Component || InstanceIndices.Num() == 0) {
+		return 0;
+	}
+
+	InstanceIndices.Sort();
+	const int32 NumInstances = Component->GetInstanceCount();
+	Component->Modify();
+
+	// Every single removal updates the cluster tree, so large removals re-add the remaining instances instead
+	if (InstanceIndices.Num() > NumInstances * HASTE_BULK_REMOVE_FRACTION) {
+		TArray<FTransform> KeptTransforms;
+		KeptTransforms.Reserve(NumInstances - InstanceIndices.Num());
+		int32 NextRemoved = 0;
+		for (int32 InstanceIndex = 0; InstanceIndex < NumInstances; InstanceIndex++) {
+			if (NextRemoved < InstanceIndices.Num() && InstanceIndices[NextRemoved] == InstanceIndex) {
+				while (NextRemoved < InstanceIndices.Num() && InstanceIndices[NextRemoved] == InstanceIndex) {
+					NextRemoved++;
+				}
+				continue;
+			}
+			KeptTransforms.Add(FTransform(Component->PerInstanceSMData[InstanceIndex].Transform));
+		}
+
+		Component->ClearInstances();
+		for (const FTransform& Transform : KeptTransforms) {
+			Component->AddInstance(Transform);
+		}
+		return NumInstances - KeptTransforms.Num();
+	}
+
+	// Remove from the back, so the indices still to be removed stay valid
+	int32 NumRemoved = 0;
+	for (int32 i = InstanceIndices.Num() - 1; i >= 0; i--) {
+		if ((i == InstanceIndices.Num() - 1 || InstanceIndices[i] != InstanceIndices[i + 1]) && Component->RemoveInstance(InstanceIndices[i])) {
+			NumRemoved++;
+		}
+	}
+	return NumRemoved;
+}
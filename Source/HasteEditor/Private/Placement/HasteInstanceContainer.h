@@ -0,0 +1,33 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+
+class UHierarchicalInstancedStaticMeshComponent;
+
+/**
+ * Haste containers are plain actors, one per level, that hold the meshes placed as instances
+ * with one hierarchical instanced component per mesh
+ */
+class FHasteInstanceContainers
+{
+public:
+	/** Finds the container of the level, creating it if required */
+	static AActor* FindOrCreateContainer(ULevel* Level);
+
+	/**
+	 * Finds the instanced component of the mesh in the container, creating it if required.
+	 * Scattered meshes get components of their own, so regenerating a scatter never touches painted or stamped instances
+	 */
+	static UHierarchicalInstancedStaticMeshComponent* FindOrCreateComponent(AActor* Container, UStaticMesh* Mesh, bool bScatter = false);
+
+	/** Adds the world space transforms as instances of the component. Returns the index of the first new instance */
+	static int32 AddInstances(UHierarchicalInstancedStaticMeshComponent* Component, const TArray<FTransform>& WorldTransforms);
+
+	/** Removes the instances from the component. The indices are sorted in place. Returns the number of removed instances */
+	static int32 RemoveInstances(UHierarchicalInstancedStaticMeshComponent* Component, TArray<int32>& InstanceIndices);
+
+	/** All the Haste containers of the world */
+	static TArray<AActor*> GetContainers(UWorld* World);
+
+	/** Returns true if the actor is a Haste container */
+	static bool IsContainer(const AActor* Actor);
+};
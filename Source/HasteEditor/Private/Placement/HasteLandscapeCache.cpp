@@ -0,0 +1,337 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteLandscapeCache.h"
+#include "Landscape.h"
+#include "LandscapeInfo.h"
+#include "LandscapeEdit.h"
+#include "LandscapeDataAccess.h"
+#include "LandscapeLayerInfoObject.h"
+
+/** Upper limit on the cached area, to keep the cache from growing unbounded on large brushes */
+#define HASTE_MAX_LANDSCAPE_CACHE_VERTICES (2048 * 2048)
+
+/** Number of bisection steps used to refine the intersection once the ray crosses the surface */
+#define HASTE_LANDSCAPE_REFINE_STEPS 8
+
+/** Cells along each side of the occluder grid */
+#define HASTE_LANDSCAPE_OCCLUDER_GRID 32
+
+/** Marks a cached vertex without any painted layer */
+#define HASTE_LANDSCAPE_NO_LAYER 0xFF
+
+FHasteLandscapeCache::FHasteLandscapeCache()
+	: LandscapeToWorld(FTransform::Identity)
+	, CachedRect(0, 0, 0, 0)
+	, OccluderCellSize(1, 1)
+	, OccluderQueryBounds(0)
+{
+}
+
+void FHasteLandscapeCache::Reset()
+{
+	LandscapeInfo.Reset();
+	Landscape.Reset();
+	SurfaceComponent.Reset();
+	Heights.Reset();
+	DominantLayers.Reset();
+	LayerPhysMaterials.Reset();
+	Occluders.Reset();
+	OccluderCells.Reset();
+	OccluderQueryBounds = FBox(0);
+}
+
+bool FHasteLandscapeCache::CacheRegion(UWorld* World, const FHitResult& SurfaceHit, const FBox& Region, const TArray<AActor*>& IgnoredActors)
+{
+	ALandscapeProxy* HitLandscape = Cast<ALandscapeProxy>(SurfaceHit.Actor.Get());
+	ULandscapeInfo* Info = HitLandscape ? HitLandscape->GetLandscapeInfo() : nullptr;
+	ALandscapeProxy* InfoLandscape = Info ? Info->GetLandscapeProxy() : nullptr;
+	if (!World || !InfoLandscape) {
+		Reset();
+		return false;
+	}
+
+	// Reuse the cached heights while the region stays inside them
+	if (IsValid() && LandscapeInfo.Get() == Info && OccluderQueryBounds.IsInside(Region)) {
+		SurfaceComponent = SurfaceHit.Component;
+		return true;
+	}
+
+	Reset();
+
+	// Cache more than requested, so a moving brush does not rebuild the cache on every frame
+	const FBox PaddedRegion = Region.ExpandBy(Region.GetExtent().GetMax());
+	const FTransform ToWorld = InfoLandscape->LandscapeActorToWorld();
+	const FBox LocalRegion = PaddedRegion.InverseTransformBy(ToWorld);
+
+	int32 MinX, MinY, MaxX, MaxY;
+	if (!Info->GetLandscapeExtent(MinX, MinY, MaxX, MaxY)) {
+		return false;
+	}
+
+	const int32 X1 = FMath::Max(MinX, FMath::FloorToInt(LocalRegion.Min.X));
+	const int32 Y1 = FMath::Max(MinY, FMath::FloorToInt(LocalRegion.Min.Y));
+	const int32 X2 = FMath::Min(MaxX, FMath::CeilToInt(LocalRegion.Max.X));
+	const int32 Y2 = FMath::Min(MaxY, FMath::CeilToInt(LocalRegion.Max.Y));
+	if (X1 >= X2 || Y1 >= Y2 || int64(X2 - X1 + 1) * (Y2 - Y1 + 1) > HASTE_MAX_LANDSCAPE_CACHE_VERTICES) {
+		return false;
+	}
+
+	Heights.SetNumZeroed((X2 - X1 + 1) * (Y2 - Y1 + 1));
+	FLandscapeEditDataInterface LandscapeEdit(Info);
+	LandscapeEdit.GetHeightDataFast(X1, Y1, X2, Y2, Heights.GetData(), 0);
+
+	LandscapeInfo = Info;
+	Landscape = InfoLandscape;
+	SurfaceComponent = SurfaceHit.Component;
+	LandscapeToWorld = ToWorld;
+	CachedRect = FIntRect(X1, Y1, X2, Y2);
+	CacheLayers(Info, LandscapeEdit);
+
+	// Anything else that blocks the brush traces inside the region may sit above the landscape.
+	// Collect it with a single overlap query, so traces near it can fall back to the physics scene
+	OccluderQueryBounds = PaddedRegion;
+	OccluderCellSize = FVector2D(PaddedRegion.GetSize()) / HASTE_LANDSCAPE_OCCLUDER_GRID;
+	OccluderCellSize = FVector2D(FMath::Max(OccluderCellSize.X, 1.0f), FMath::Max(OccluderCellSize.Y, 1.0f));
+	OccluderCells.SetNum(HASTE_LANDSCAPE_OCCLUDER_GRID * HASTE_LANDSCAPE_OCCLUDER_GRID);
+	TArray<FOverlapResult> Overlaps;
+	static FName NAME_HasteLandscapeCache = FName(TEXT("HasteLandscapeCache"));
+	FCollisionQueryParams QueryParams(NAME_HasteLandscapeCache, false);
+	QueryParams.AddIgnoredActors(IgnoredActors);
+	World->OverlapMultiByChannel(Overlaps, PaddedRegion.GetCenter(), FQuat::Identity, ECC_WorldStatic, FCollisionShape::MakeBox(PaddedRegion.GetExtent()), QueryParams);
+	for (const FOverlapResult& Overlap : Overlaps) {
+		UPrimitiveComponent* Component = Overlap.Component.Get();
+		if (Component && !Cast<ALandscapeProxy>(Component->GetOwner())) {
+			AddOccluder(Component->Bounds.GetBox());
+		}
+	}
+	return true;
+}
+
+void FHasteLandscapeCache::CacheLayers(ULandscapeInfo* Info, FLandscapeEditDataInterface& LandscapeEdit)
+{
+	TArray<ULandscapeLayerInfoObject*> LayerInfos;
+	bool bHasPhysMaterial = false;
+	for (const FLandscapeInfoLayerSettings& Layer : Info->Layers) {
+		ULandscapeLayerInfoObject* LayerInfo = Layer.LayerInfoObj;
+		if (LayerInfo && LayerInfo != ALandscapeProxy::VisibilityLayer && LayerInfos.Num() < HASTE_LANDSCAPE_NO_LAYER) {
+			LayerInfos.Add(LayerInfo);
+			LayerPhysMaterials.Add(LayerInfo->PhysMaterial);
+			bHasPhysMaterial |= (LayerInfo->PhysMaterial != nullptr);
+		}
+	}
+
+	// Without layer materials, every hit reports the default material of the landscape
+	if (!bHasPhysMaterial) {
+		LayerPhysMaterials.Reset();
+		return;
+	}
+
+	const int32 NumVertices = Heights.Num();
+	DominantLayers.Init(HASTE_LANDSCAPE_NO_LAYER, NumVertices);
+	TArray<uint8> DominantWeights;
+	DominantWeights.SetNumZeroed(NumVertices);
+	TArray<uint8> Weights;
+	Weights.SetNumUninitialized(NumVertices);
+	for (int32 LayerIndex = 0; LayerIndex < LayerInfos.Num(); LayerIndex++) {
+		FMemory::Memzero(Weights.GetData(), NumVertices);
+		LandscapeEdit.GetWeightDataFast(LayerInfos[LayerIndex], CachedRect.Min.X, CachedRect.Min.Y, CachedRect.Max.X, CachedRect.Max.Y, Weights.GetData(), 0);
+		for (int32 i = 0; i < NumVertices; i++) {
+			if (Weights[i] > DominantWeights[i]) {
+				DominantWeights[i] = Weights[i];
+				DominantLayers[i] = uint8(LayerIndex);
+			}
+		}
+	}
+}
+
+void FHasteLandscapeCache::GetOccluderCells(const FBox& Bounds, FIntPoint& OutMin, FIntPoint& OutMax) const
+{
+	const int32 LastCell = HASTE_LANDSCAPE_OCCLUDER_GRID - 1;
+	OutMin.X = FMath::Clamp(FMath::FloorToInt((Bounds.Min.X - OccluderQueryBounds.Min.X) / OccluderCellSize.X), 0, LastCell);
+	OutMin.Y = FMath::Clamp(FMath::FloorToInt((Bounds.Min.Y - OccluderQueryBounds.Min.Y) / OccluderCellSize.Y), 0, LastCell);
+	OutMax.X = FMath::Clamp(FMath::FloorToInt((Bounds.Max.X - OccluderQueryBounds.Min.X) / OccluderCellSize.X), 0, LastCell);
+	OutMax.Y = FMath::Clamp(FMath::FloorToInt((Bounds.Max.Y - OccluderQueryBounds.Min.Y) / OccluderCellSize.Y), 0, LastCell);
+}
+
+void FHasteLandscapeCache::AddOccluder(const FBox& Bounds)
+{
+	if (!IsValid() || !OccluderQueryBounds.Intersect(Bounds)) {
+		return;
+	}
+
+	const int32 OccluderIndex = Occluders.Add(Bounds);
+	FIntPoint Min, Max;
+	GetOccluderCells(Bounds, Min, Max);
+	for (int32 Y = Min.Y; Y <= Max.Y; Y++) {
+		for (int32 X = Min.X; X <= Max.X; X++) {
+			OccluderCells[Y * HASTE_LANDSCAPE_OCCLUDER_GRID + X].Add(OccluderIndex);
+		}
+	}
+}
+
+bool FHasteLandscapeCache::IsOccluded(const FBox& Bounds) const
+{
+	// Read only, so the workers of a bulk placement can trace the same cache.
+	// An occluder spanning several cells may be tested more than once, which is cheaper than tracking the visits
+	FIntPoint Min, Max;
+	GetOccluderCells(Bounds, Min, Max);
+	for (int32 Y = Min.Y; Y <= Max.Y; Y++) {
+		for (int32 X = Min.X; X <= Max.X; X++) {
+			for (int32 OccluderIndex : OccluderCells[Y * HASTE_LANDSCAPE_OCCLUDER_GRID + X]) {
+				if (Occluders[OccluderIndex].Intersect(Bounds)) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+bool FHasteLandscapeCache::SampleHeight(float LocalX, float LocalY, float& OutHeight) const
+{
+	const int32 Width = CachedRect.Width() + 1;
+	const int32 Height = CachedRect.Height() + 1;
+	const float X = LocalX - CachedRect.Min.X;
+	const float Y = LocalY - CachedRect.Min.Y;
+	if (X < 0 || Y < 0 || X > Width - 1 || Y > Height - 1) {
+		return false;
+	}
+
+	const int32 X0 = FMath::Min(FMath::FloorToInt(X), Width - 2);
+	const int32 Y0 = FMath::Min(FMath::FloorToInt(Y), Height - 2);
+	const float FracX = X - X0;
+	const float FracY = Y - Y0;
+
+	const uint16* Row0 = &Heights[Y0 * Width + X0];
+	const uint16* Row1 = Row0 + Width;
+	const float H00 = LandscapeDataAccess::GetLocalHeight(Row0[0]);
+	const float H10 = LandscapeDataAccess::GetLocalHeight(Row0[1]);
+	const float H01 = LandscapeDataAccess::GetLocalHeight(Row1[0]);
+	const float H11 = LandscapeDataAccess::GetLocalHeight(Row1[1]);
+	OutHeight = FMath::Lerp(FMath::Lerp(H00, H10, FracX), FMath::Lerp(H01, H11, FracX), FracY);
+	return true;
+}
+
+FVector FHasteLandscapeCache::SampleNormal(float LocalX, float LocalY, float LocalZ) const
+{
+	// Central differences, falling back to the center height at the border of the cache
+	float Left = LocalZ, Right = LocalZ, Down = LocalZ, Up = LocalZ;
+	SampleHeight(LocalX - 1, LocalY, Left);
+	SampleHeight(LocalX + 1, LocalY, Right);
+	SampleHeight(LocalX, LocalY - 1, Down);
+	SampleHeight(LocalX, LocalY + 1, Up);
+
+	const FVector TangentX = LandscapeToWorld.TransformVector(FVector(2, 0, Right - Left));
+	const FVector TangentY = LandscapeToWorld.TransformVector(FVector(0, 2, Up - Down));
+	return (TangentX ^ TangentY).GetSafeNormal();
+}
+
+UPhysicalMaterial* FHasteLandscapeCache::SamplePhysMaterial(float LocalX, float LocalY) const
+{
+	UPhysicalMaterial* PhysMaterial = nullptr;
+	if (DominantLayers.Num() > 0) {
+		const int32 Width = CachedRect.Width() + 1;
+		const int32 X = FMath::Clamp(FMath::RoundToInt(LocalX) - CachedRect.Min.X, 0, CachedRect.Width());
+		const int32 Y = FMath::Clamp(FMath::RoundToInt(LocalY) - CachedRect.Min.Y, 0, CachedRect.Height());
+		const uint8 Layer = DominantLayers[Y * Width + X];
+		if (Layer != HASTE_LANDSCAPE_NO_LAYER) {
+			PhysMaterial = LayerPhysMaterials[Layer].Get();
+		}
+	}
+
+	// Layers without a material of their own fall back to the landscape default, like the collision does
+	if (!PhysMaterial) {
+		ALandscapeProxy* LandscapeProxy = Landscape.Get();
+		PhysMaterial = (LandscapeProxy && LandscapeProxy->DefaultPhysMaterial) ? LandscapeProxy->DefaultPhysMaterial : GEngine->DefaultPhysMaterial;
+	}
+	return PhysMaterial;
+}
+
+bool FHasteLandscapeCache::Trace(const FVector& Start, const FVector& End, FHitResult& OutHit) const
+{
+	if (!IsValid()) {
+		return false;
+	}
+
+	FBox SegmentBounds(Start, Start);
+	SegmentBounds += End;
+	if (!OccluderQueryBounds.IsInside(SegmentBounds)) {
+		return false;
+	}
+	if (IsOccluded(SegmentBounds)) {
+		return false;
+	}
+
+	// March along the segment in landscape space at half quad steps until it goes below the surface
+	const FVector LocalStart = LandscapeToWorld.InverseTransformPosition(Start);
+	const FVector LocalEnd = LandscapeToWorld.InverseTransformPosition(End);
+	auto HeightAboveSurface = [&](float T, float& OutDelta) -> bool {
+		const FVector Point = FMath::Lerp(LocalStart, LocalEnd, T);
+		float SurfaceHeight;
+		if (!SampleHeight(Point.X, Point.Y, SurfaceHeight)) {
+			return false;
+		}
+		OutDelta = Point.Z - SurfaceHeight;
+		return true;
+	};
+
+	float Delta;
+	if (!HeightAboveSurface(0, Delta) || Delta < 0) {
+		return false;
+	}
+
+	const float LocalLength = FVector2D(LocalEnd - LocalStart).Size();
+	const int32 NumSteps = FMath::Clamp(FMath::CeilToInt(LocalLength * 2), 1, 4096);
+	float PrevT = 0;
+	for (int32 Step = 1; Step <= NumSteps; Step++) {
+		const float T = float(Step) / NumSteps;
+		if (!HeightAboveSurface(T, Delta)) {
+			return false;
+		}
+		if (Delta > 0) {
+			PrevT = T;
+			continue;
+		}
+
+		// Refine the crossing between the last two samples
+		float AboveT = PrevT;
+		float BelowT = T;
+		for (int32 i = 0; i < HASTE_LANDSCAPE_REFINE_STEPS; i++) {
+			const float MidT = (AboveT + BelowT) * 0.5f;
+			if (!HeightAboveSurface(MidT, Delta)) {
+				return false;
+			}
+			if (Delta > 0) {
+				AboveT = MidT;
+			}
+			else {
+				BelowT = MidT;
+			}
+		}
+
+		// Put the hit on the surface. This is exact for vertical segments, where the bisection alone is coarse
+		FVector LocalHit = FMath::Lerp(LocalStart, LocalEnd, BelowT);
+		float SurfaceHeight;
+		if (SampleHeight(LocalHit.X, LocalHit.Y, SurfaceHeight)) {
+			LocalHit.Z = SurfaceHeight;
+		}
+		const FVector Location = LandscapeToWorld.TransformPosition(LocalHit);
+		const FVector Normal = SampleNormal(LocalHit.X, LocalHit.Y, LocalHit.Z);
+		ALandscapeProxy* LandscapeProxy = Landscape.Get();
+
+		OutHit = FHitResult(BelowT);
+		OutHit.bBlockingHit = true;
+		OutHit.Location = Location;
+		OutHit.ImpactPoint = Location;
+		OutHit.Normal = Normal;
+		OutHit.ImpactNormal = Normal;
+		OutHit.TraceStart = Start;
+		OutHit.TraceEnd = End;
+		OutHit.Distance = (Location - Start).Size();
+		OutHit.Actor = LandscapeProxy;
+		OutHit.Component = SurfaceComponent;
+		OutHit.PhysMaterial = SamplePhysMaterial(LocalHit.X, LocalHit.Y);
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,81 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+
+class ALandscapeProxy;
+class ULandscapeInfo;
+class FLandscapeEditDataInterface;
+
+/**
+ * CPU copy of the landscape heights around the brush, used to project placements on to
+ * a landscape with memory reads instead of physics traces.
+ * Anything other than the landscape inside the cached region is recorded as an occluder,
+ * and traces that may touch an occluder are left to the physics scene
+ */
+class FHasteLandscapeCache
+{
+public:
+	FHasteLandscapeCache();
+
+	void Reset();
+
+	/**
+	 * Makes sure the heights under the region are cached, if the surface hit is a landscape.
+	 * Returns false if the surface is not a landscape, in which case the cache is cleared.
+	 * The ignored actors are not recorded as occluders, for traces that ignore them as well
+	 */
+	bool CacheRegion(UWorld* World, const FHitResult& SurfaceHit, const FBox& Region, const TArray<AActor*>& IgnoredActors = TArray<AActor*>());
+
+	/** Registers a primitive that was placed inside the cached region after it was built */
+	void AddOccluder(const FBox& Bounds);
+
+	/**
+	 * Intersects the segment with the cached heightfield.
+	 * Returns false if the segment leaves the cached area, may be blocked by an occluder or misses the landscape
+	 */
+	bool Trace(const FVector& Start, const FVector& End, FHitResult& OutHit) const;
+
+	bool IsValid() const { return Heights.Num() > 0 && LandscapeInfo.IsValid() && Landscape.IsValid(); }
+
+private:
+	/** Bilinear height in landscape local space. Returns false outside of the cached area */
+	bool SampleHeight(float LocalX, float LocalY, float& OutHeight) const;
+
+	/** World space surface normal at the landscape local position */
+	FVector SampleNormal(float LocalX, float LocalY, float LocalZ) const;
+
+	/** Physical material of the dominant layer at the landscape local position, as reported by the landscape collision */
+	UPhysicalMaterial* SamplePhysMaterial(float LocalX, float LocalY) const;
+
+	/** Finds the dominant layer of every cached vertex, if any layer of the landscape has a physical material */
+	void CacheLayers(ULandscapeInfo* Info, FLandscapeEditDataInterface& LandscapeEdit);
+
+	/** Range of occluder grid cells covered by the box */
+	void GetOccluderCells(const FBox& Bounds, FIntPoint& OutMin, FIntPoint& OutMax) const;
+
+	/** Returns true if the box touches an occluder */
+	bool IsOccluded(const FBox& Bounds) const;
+
+private:
+	TWeakObjectPtr<ULandscapeInfo> LandscapeInfo;
+	TWeakObjectPtr<ALandscapeProxy> Landscape;
+	TWeakObjectPtr<UPrimitiveComponent> SurfaceComponent;
+	FTransform LandscapeToWorld;
+
+	/** Cached landscape vertex range (inclusive) */
+	FIntRect CachedRect;
+	TArray<uint16> Heights;
+
+	/** Index into LayerPhysMaterials of the dominant layer of every cached vertex. Empty if no layer has a physical material */
+	TArray<uint8> DominantLayers;
+	TArray<TWeakObjectPtr<UPhysicalMaterial>> LayerPhysMaterials;
+
+	/** World space bounds of the non-landscape primitives inside the cached region */
+	TArray<FBox> Occluders;
+
+	/** Occluder indices hashed into a uniform grid over the occluder query bounds, so a trace only tests its neighbours */
+	TArray<TArray<int32>> OccluderCells;
+	FVector2D OccluderCellSize;
+
+	/** World space region that was searched for occluders */
+	FBox OccluderQueryBounds;
+};
@@ -0,0 +1,145 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteMeshBounds.h"
+
+namespace
+{
+	bool IsSeparatingAxis(const FVector& Axis, const FVector& Delta, const FVector AxesA[3], const FVector& ExtentA, const FVector AxesB[3], const FVector& ExtentB)
+	{
+		// Parallel edges produce a degenerate axis, which is covered by the face axes
+		if (Axis.SizeSquared() < KINDA_SMALL_NUMBER) {
+			return false;
+		}
+
+		const float ProjA =
+			ExtentA.X * FMath::Abs(AxesA[0] | Axis) +
+			ExtentA.Y * FMath::Abs(AxesA[1] | Axis) +
+			ExtentA.Z * FMath::Abs(AxesA[2] | Axis);
+		const float ProjB =
+			ExtentB.X * FMath::Abs(AxesB[0] | Axis) +
+			ExtentB.Y * FMath::Abs(AxesB[1] | Axis) +
+			ExtentB.Z * FMath::Abs(AxesB[2] | Axis);
+		return FMath::Abs(Delta | Axis) > ProjA + ProjB;
+	}
+
+	/** Separating axis test between two oriented boxes */
+	bool OrientedBoxesOverlap(const FHastePlacedBounds& A, const FHastePlacedBounds& B)
+	{
+		const FVector AxesA[3] = { A.Rotation.GetAxisX(), A.Rotation.GetAxisY(), A.Rotation.GetAxisZ() };
+		const FVector AxesB[3] = { B.Rotation.GetAxisX(), B.Rotation.GetAxisY(), B.Rotation.GetAxisZ() };
+		const FVector Delta = B.Center - A.Center;
+
+		for (int32 i = 0; i < 3; i++) {
+			if (IsSeparatingAxis(AxesA[i], Delta, AxesA, A.Extent, AxesB, B.Extent)) return false;
+			if (IsSeparatingAxis(AxesB[i], Delta, AxesA, A.Extent, AxesB, B.Extent)) return false;
+		}
+		for (int32 i = 0; i < 3; i++) {
+			for (int32 j = 0; j < 3; j++) {
+				if (IsSeparatingAxis(AxesA[i] ^ AxesB[j], Delta, AxesA, A.Extent, AxesB, B.Extent)) return false;
+			}
+		}
+		return true;
+	}
+}
+
+FBox FHastePlacedBounds::GetBoundingBox() const
+{
+	switch (Shape)
+	{
+	case EHasteBoundsShape::Capsule:
+	{
+		const FVector Axis = Rotation.GetAxisZ() * HalfHeight;
+		FBox Box(Center - Axis, Center - Axis);
+		Box += Center + Axis;
+		return Box.ExpandBy(Radius);
+	}
+
+	case EHasteBoundsShape::Box:
+		return FBox(-Extent, Extent).TransformBy(FTransform(Rotation, Center));
+
+	case EHasteBoundsShape::Sphere:
+	default:
+		return FBox(Center - FVector(Radius), Center + FVector(Radius));
+	}
+}
+
+bool FHastePlacedBounds::Overlaps(const FHastePlacedBounds& Other) const
+{
+	switch (Shape)
+	{
+	case EHasteBoundsShape::Capsule:
+	{
+		const FVector AxisA = Rotation.GetAxisZ() * HalfHeight;
+		const FVector AxisB = Other.Rotation.GetAxisZ() * Other.HalfHeight;
+		FVector ClosestA, ClosestB;
+		FMath::SegmentDistToSegmentSafe(Center - AxisA, Center + AxisA, Other.Center - AxisB, Other.Center + AxisB, ClosestA, ClosestB);
+		return FVector::DistSquared(ClosestA, ClosestB) < FMath::Square(Radius + Other.Radius);
+	}
+
+	case EHasteBoundsShape::Box:
+		return OrientedBoxesOverlap(*this, Other);
+
+	case EHasteBoundsShape::Sphere:
+	default:
+		return FVector::DistSquared(Center, Other.Center) < FMath::Square(Radius + Other.Radius);
+	}
+}
+
+FHasteMeshBounds::FHasteMeshBounds()
+	: Shape(EHasteBoundsShape::Sphere)
+	, Center(FVector::ZeroVector)
+	, Extent(FVector::ZeroVector)
+	, Radius(0)
+	, HalfHeight(0)
+{
+}
+
+FHasteMeshBounds FHasteMeshBounds::Create(UStaticMesh* Mesh, EHasteBoundsShape Shape)
+{
+	if (!Mesh) {
+		FHasteMeshBounds Bounds;
+		Bounds.Shape = Shape;
+		return Bounds;
+	}
+	return Create(Mesh->GetBounds(), Shape);
+}
+
+FHasteMeshBounds FHasteMeshBounds::Create(const FBoxSphereBounds& RenderBounds, EHasteBoundsShape Shape)
+{
+	FHasteMeshBounds Bounds;
+	Bounds.Shape = Shape;
+	Bounds.Center = RenderBounds.Origin;
+	Bounds.Extent = RenderBounds.BoxExtent;
+
+	switch (Shape)
+	{
+	case EHasteBoundsShape::Capsule:
+		Bounds.Radius = FMath::Max(RenderBounds.BoxExtent.X, RenderBounds.BoxExtent.Y);
+		Bounds.HalfHeight = FMath::Max(RenderBounds.BoxExtent.Z - Bounds.Radius, 0.0f);
+		break;
+
+	case EHasteBoundsShape::Box:
+		Bounds.Radius = RenderBounds.BoxExtent.Size();
+		break;
+
+	case EHasteBoundsShape::Sphere:
+	default:
+		Bounds.Radius = RenderBounds.SphereRadius;
+		break;
+	}
+	return Bounds;
+}
+
+FHastePlacedBounds FHasteMeshBounds::ToWorld(const FTransform& Transform, float Scale) const
+{
+	const FVector Scale3D = Transform.GetScale3D().GetAbs() * Scale;
+
+	FHastePlacedBounds Placed;
+	Placed.Shape = Shape;
+	Placed.Center = Transform.TransformPosition(Center);
+	Placed.Rotation = Transform.GetRotation();
+	Placed.Extent = Extent * Scale3D;
+	Placed.Radius = Radius * (Shape == EHasteBoundsShape::Capsule ? FMath::Max(Scale3D.X, Scale3D.Y) : Scale3D.GetMax());
+	Placed.HalfHeight = HalfHeight * Scale3D.Z;
+	return Placed;
+}
@@ -0,0 +1,50 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "HastePlacement.h"
+
+/**
+ * World space simplified bounds of a placed mesh.
+ * Capsules are aligned to the local Z axis of the placement
+ */
+struct FHastePlacedBounds
+{
+	EHasteBoundsShape Shape;
+	FVector Center;
+	FQuat Rotation;
+
+	/** Half size of the box shape */
+	FVector Extent;
+
+	/** Radius of the sphere and capsule shapes */
+	float Radius;
+
+	/** Half length of the capsule's inner segment */
+	float HalfHeight;
+
+	/** Axis aligned box that fully encloses the shape */
+	FBox GetBoundingBox() const;
+
+	/** Checks if the two shapes interpenetrate. Both shapes are expected to be of the same type */
+	bool Overlaps(const FHastePlacedBounds& Other) const;
+};
+
+/**
+ * Local space simplified bounds of a static mesh, derived from its render bounds
+ */
+struct FHasteMeshBounds
+{
+	FHasteMeshBounds();
+
+	EHasteBoundsShape Shape;
+	FVector Center;
+	FVector Extent;
+	float Radius;
+	float HalfHeight;
+
+	/** Build the simplified bounds of the mesh */
+	static FHasteMeshBounds Create(UStaticMesh* Mesh, EHasteBoundsShape Shape);
+	static FHasteMeshBounds Create(const FBoxSphereBounds& RenderBounds, EHasteBoundsShape Shape);
+
+	/** Move the bounds into world space. Scale is used to grow or shrink the shape (e.g. to allow slight interpenetration) */
+	FHastePlacedBounds ToWorld(const FTransform& Transform, float Scale) const;
+};
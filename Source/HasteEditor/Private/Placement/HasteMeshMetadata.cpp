@@ -0,0 +1,245 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteMeshMetadata.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Engine/StaticMeshSocket.h"
+
+FHasteMeshMetadata::FHasteMeshMetadata()
+	: Bounds(ForceInitToZero)
+	, PivotToBottom(0)
+	, CollisionBox(0)
+	, NumLODs(0)
+	, FirstSocket(0)
+	, NumSockets(0)
+{
+	FMemory::Memzero(LODScreenSizes);
+}
+
+FHasteMeshMetadataCache* FHasteMeshMetadataCache::Instance = nullptr;
+
+void FHasteMeshMetadataCache::Initialize()
+{
+	if (!Instance) {
+		Instance = new FHasteMeshMetadataCache();
+	}
+}
+
+void FHasteMeshMetadataCache::Shutdown()
+{
+	delete Instance;
+	Instance = nullptr;
+}
+
+FHasteMeshMetadataCache& FHasteMeshMetadataCache::Get()
+{
+	check(Instance);
+	return *Instance;
+}
+
+FHasteMeshMetadataCache::FHasteMeshMetadataCache()
+{
+	FEditorDelegates::OnAssetPreImport.AddRaw(this, &FHasteMeshMetadataCache::OnAssetPreImport);
+	ObjectPropertyChangedDelegate = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FHasteMeshMetadataCache::OnObjectPropertyChanged);
+}
+
+FHasteMeshMetadataCache::~FHasteMeshMetadataCache()
+{
+	FEditorDelegates::OnAssetPreImport.RemoveAll(this);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedDelegate);
+	if (GEditor) {
+		GEditor->OnObjectReimported().Remove(ObjectReimportedDelegate);
+	}
+	Flush();
+}
+
+void FHasteMeshMetadataCache::Request(const TArray<UStaticMesh*>& Meshes)
+{
+	for (UStaticMesh* Mesh : Meshes) {
+		if (!Mesh || EntryIndices.Contains(Mesh)) continue;
+		if (PendingBuilds.ContainsByPredicate([Mesh](const FPendingBuild& Build) { return Build.Mesh == Mesh; })) continue;
+
+		FPendingBuild Build;
+		Build.Mesh = Mesh;
+		Build.Result = Async<FBuildResult>(EAsyncExecution::ThreadPool, [Mesh]() { return FHasteMeshMetadataCache::Build(Mesh); });
+		PendingBuilds.Add(MoveTemp(Build));
+	}
+}
+
+const FHasteMeshMetadata& FHasteMeshMetadataCache::Get(UStaticMesh* Mesh)
+{
+	check(Mesh);
+	int32 EntryIndex;
+	if (const int32* FoundIndex = EntryIndices.Find(Mesh)) {
+		EntryIndex = *FoundIndex;
+	}
+	else {
+		EntryIndex = CompletePendingBuild(Mesh);
+		if (EntryIndex == INDEX_NONE) {
+			EntryIndex = Store(Build(Mesh));
+		}
+	}
+	return Entries[EntryIndex];
+}
+
+const FHasteMeshMetadata* FHasteMeshMetadataCache::Find(UStaticMesh* Mesh) const
+{
+	const int32* EntryIndex = EntryIndices.Find(Mesh);
+	return EntryIndex ? &Entries[*EntryIndex] : nullptr;
+}
+
+void FHasteMeshMetadataCache::GetSockets(const FHasteMeshMetadata& Metadata, TArray<FHasteMeshSocket>& OutSockets) const
+{
+	OutSockets.Reset(Metadata.NumSockets);
+	OutSockets.Append(Sockets.GetData() + Metadata.FirstSocket, Metadata.NumSockets);
+}
+
+void FHasteMeshMetadataCache::Tick(float DeltaTime)
+{
+	// The cache is created before the editor engine, so the reimport event is bound on the first tick
+	if (!ObjectReimportedDelegate.IsValid() && GEditor) {
+		ObjectReimportedDelegate = GEditor->OnObjectReimported().AddRaw(this, &FHasteMeshMetadataCache::OnObjectReimported);
+	}
+
+	StoreFinishedBuilds();
+}
+
+TStatId FHasteMeshMetadataCache::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FHasteMeshMetadataCache, STATGROUP_Tickables);
+}
+
+void FHasteMeshMetadataCache::StoreFinishedBuilds()
+{
+	for (int32 i = PendingBuilds.Num() - 1; i >= 0; i--) {
+		if (PendingBuilds[i].Result.IsReady()) {
+			Store(PendingBuilds[i].Result.Get());
+			PendingBuilds.RemoveAtSwap(i, 1, false);
+		}
+	}
+}
+
+void FHasteMeshMetadataCache::Invalidate(UStaticMesh* Mesh)
+{
+	// A build that started before the change may have read stale data
+	for (int32 i = PendingBuilds.Num() - 1; i >= 0; i--) {
+		if (PendingBuilds[i].Mesh == Mesh) {
+			PendingBuilds[i].Result.Wait();
+			PendingBuilds.RemoveAtSwap(i, 1, false);
+		}
+	}
+
+	int32 EntryIndex;
+	if (!EntryIndices.RemoveAndCopyValue(Mesh, EntryIndex)) {
+		MeshInvalidated.Broadcast(Mesh);
+		return;
+	}
+
+	Entries.RemoveAtSwap(EntryIndex, 1, false);
+	if (Entries.IsValidIndex(EntryIndex)) {
+		EntryIndices.Add(Entries[EntryIndex].Mesh, EntryIndex);
+	}
+
+	// Compact the socket pool, so reimports do not grow it
+	TArray<FHasteMeshSocket> OldSockets = MoveTemp(Sockets);
+	Sockets.Reset(OldSockets.Num());
+	for (FHasteMeshMetadata& Entry : Entries) {
+		const int32 FirstSocket = Sockets.Num();
+		Sockets.Append(OldSockets.GetData() + Entry.FirstSocket, Entry.NumSockets);
+		Entry.FirstSocket = FirstSocket;
+	}
+
+	MeshInvalidated.Broadcast(Mesh);
+}
+
+void FHasteMeshMetadataCache::Flush()
+{
+	for (FPendingBuild& Build : PendingBuilds) {
+		Build.Result.Wait();
+	}
+	StoreFinishedBuilds();
+}
+
+void FHasteMeshMetadataCache::OnAssetPreImport(UFactory* Factory, UClass* Class, UObject* Parent, const FName& Name, const TCHAR* Type)
+{
+	// The background builds read the meshes, so they have to finish before an import replaces their data
+	Flush();
+}
+
+void FHasteMeshMetadataCache::OnObjectReimported(UObject* Object)
+{
+	if (UStaticMesh* Mesh = Cast<UStaticMesh>(Object)) {
+		Invalidate(Mesh);
+	}
+}
+
+void FHasteMeshMetadataCache::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// Sockets and collision are edited in the mesh editor without a reimport
+	if (UStaticMesh* Mesh = Cast<UStaticMesh>(Object)) {
+		Invalidate(Mesh);
+	}
+}
+
+void FHasteMeshMetadataCache::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (FPendingBuild& Build : PendingBuilds) {
+		Collector.AddReferencedObject(Build.Mesh);
+	}
+}
+
+FHasteMeshMetadataCache::FBuildResult FHasteMeshMetadataCache::Build(UStaticMesh* Mesh)
+{
+	FBuildResult Result;
+	FHasteMeshMetadata& Metadata = Result.Metadata;
+	Metadata.Mesh = Mesh;
+	Metadata.Bounds = Mesh->GetBounds();
+	Metadata.PivotToBottom = Metadata.Bounds.BoxExtent.Z - Metadata.Bounds.Origin.Z;
+
+	const UBodySetup* BodySetup = Mesh->BodySetup;
+	Metadata.CollisionBox = (BodySetup && BodySetup->AggGeom.GetElementCount() > 0)
+		? BodySetup->AggGeom.CalcAABB(FTransform::Identity)
+		: Metadata.Bounds.GetBox();
+
+	if (const FStaticMeshRenderData* RenderData = Mesh->RenderData.Get()) {
+		Metadata.NumLODs = FMath::Min(RenderData->LODResources.Num(), MAX_STATIC_MESH_LODS);
+		for (int32 LODIndex = 0; LODIndex < Metadata.NumLODs; LODIndex++) {
+			Metadata.LODScreenSizes[LODIndex] = RenderData->ScreenSize[LODIndex];
+		}
+	}
+
+	for (const UStaticMeshSocket* Socket : Mesh->Sockets) {
+		if (Socket) {
+			FHasteMeshSocket& MeshSocket = Result.Sockets[Result.Sockets.AddUninitialized()];
+			MeshSocket.Name = Socket->SocketName;
+			MeshSocket.RelativeTransform = FTransform(Socket->RelativeRotation, Socket->RelativeLocation, Socket->RelativeScale);
+		}
+	}
+	Metadata.NumSockets = Result.Sockets.Num();
+	return Result;
+}
+
+int32 FHasteMeshMetadataCache::Store(const FBuildResult& Result)
+{
+	UStaticMesh* Mesh = Result.Metadata.Mesh.Get();
+	if (int32* ExistingIndex = EntryIndices.Find(Mesh)) {
+		return *ExistingIndex;
+	}
+
+	const int32 EntryIndex = Entries.Add(Result.Metadata);
+	Entries[EntryIndex].FirstSocket = Sockets.Num();
+	Sockets.Append(Result.Sockets);
+	EntryIndices.Add(Mesh, EntryIndex);
+	return EntryIndex;
+}
+
+int32 FHasteMeshMetadataCache::CompletePendingBuild(UStaticMesh* Mesh)
+{
+	const int32 PendingIndex = PendingBuilds.IndexOfByPredicate([Mesh](const FPendingBuild& Build) { return Build.Mesh == Mesh; });
+	if (PendingIndex == INDEX_NONE) {
+		return INDEX_NONE;
+	}
+
+	const int32 EntryIndex = Store(PendingBuilds[PendingIndex].Result.Get());
+	PendingBuilds.RemoveAtSwap(PendingIndex, 1, false);
+	return EntryIndex;
+}
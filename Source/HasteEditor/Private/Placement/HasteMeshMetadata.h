@@ -0,0 +1,130 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "StaticMeshResources.h"
+#include "TickableEditorObject.h"
+#include "Async.h"
+
+/** A socket of a cached mesh, relative to the mesh pivot */
+struct FHasteMeshSocket
+{
+	FName Name;
+	FTransform RelativeTransform;
+};
+
+/**
+ * Placement data of a static mesh, read once from its render data and body setup
+ */
+struct FHasteMeshMetadata
+{
+	FHasteMeshMetadata();
+
+	TWeakObjectPtr<UStaticMesh> Mesh;
+
+	/** Local render bounds */
+	FBoxSphereBounds Bounds;
+
+	/** Distance from the pivot down to the bottom of the bounds. Positive when the pivot is above the bottom */
+	float PivotToBottom;
+
+	/** Local bounding box of the simple collision, or of the render bounds if the mesh has no simple collision */
+	FBox CollisionBox;
+
+	/** Screen size at which each LOD is used */
+	float LODScreenSizes[MAX_STATIC_MESH_LODS];
+	int32 NumLODs;
+
+	/** Range of the mesh sockets in the socket pool of the cache */
+	int32 FirstSocket;
+	int32 NumSockets;
+};
+
+/**
+ * Metadata of the meshes in the brush palette, kept in a compact array so the placement paths
+ * never walk the render data or body setup. Entries are built on the thread pool when the meshes are selected.
+ * The cache lives as long as the module, so meshes edited or reimported outside of the Haste mode are invalidated as well
+ */
+class FHasteMeshMetadataCache : public FTickableEditorObject, public FGCObject
+{
+public:
+	/** Created and destroyed by the module */
+	static void Initialize();
+	static void Shutdown();
+
+	/** The cache of the editor session. Only valid while the module is loaded */
+	static FHasteMeshMetadataCache& Get();
+
+	/** Broadcast after the metadata of a mesh was dropped, so anything derived from it can be dropped too */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnMeshInvalidated, UStaticMesh*);
+	FOnMeshInvalidated& OnMeshInvalidated() { return MeshInvalidated; }
+
+	/** Starts building the metadata of the meshes that are not cached or being built yet */
+	void Request(const TArray<UStaticMesh*>& Meshes);
+
+	/** Returns the metadata of the mesh, building it now if the background build has not finished. Valid until the cache is modified */
+	const FHasteMeshMetadata& Get(UStaticMesh* Mesh);
+
+	/** Returns the metadata of the mesh if it is built, without blocking */
+	const FHasteMeshMetadata* Find(UStaticMesh* Mesh) const;
+
+	/** Copies the sockets of a cached mesh */
+	void GetSockets(const FHasteMeshMetadata& Metadata, TArray<FHasteMeshSocket>& OutSockets) const;
+
+	/** FTickableEditorObject interface. Moves the finished background builds into the cache */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return true; }
+	virtual TStatId GetStatId() const override;
+
+	/** Drops the metadata of the mesh (e.g. when it is reimported), so it is built again on the next request */
+	void Invalidate(UStaticMesh* Mesh);
+
+	/** Blocks until every background build has finished */
+	void Flush();
+
+	/** FGCObject interface. Keeps the meshes that are being built alive */
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+private:
+	FHasteMeshMetadataCache();
+	virtual ~FHasteMeshMetadataCache();
+
+	/** Moves the finished background builds into the cache */
+	void StoreFinishedBuilds();
+
+	void OnAssetPreImport(UFactory* Factory, UClass* Class, UObject* Parent, const FName& Name, const TCHAR* Type);
+	void OnObjectReimported(UObject* Object);
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+
+private:
+	struct FBuildResult
+	{
+		FHasteMeshMetadata Metadata;
+		TArray<FHasteMeshSocket> Sockets;
+	};
+
+	struct FPendingBuild
+	{
+		UStaticMesh* Mesh;
+		TFuture<FBuildResult> Result;
+	};
+
+	/** Reads the metadata from the mesh. Does not touch the cache, so it can run on any thread */
+	static FBuildResult Build(UStaticMesh* Mesh);
+
+	/** Adds a built entry to the cache and returns its index */
+	int32 Store(const FBuildResult& Result);
+
+	/** Waits for the pending build of the mesh and stores it. Returns the entry index, or INDEX_NONE if it was not being built */
+	int32 CompletePendingBuild(UStaticMesh* Mesh);
+
+private:
+	TArray<FHasteMeshMetadata> Entries;
+	TMap<TWeakObjectPtr<UStaticMesh>, int32> EntryIndices;
+	TArray<FHasteMeshSocket> Sockets;
+	TArray<FPendingBuild> PendingBuilds;
+
+	FOnMeshInvalidated MeshInvalidated;
+	FDelegateHandle ObjectReimportedDelegate;
+	FDelegateHandle ObjectPropertyChangedDelegate;
+
+	static FHasteMeshMetadataCache* Instance;
+};
@@ -0,0 +1,233 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteOverlapFilter.h"
+#include "HasteMeshMetadata.h"
+
+FHasteOverlapFilter::FHasteOverlapFilter()
+	: MetadataCache(nullptr)
+	, Shape(EHasteBoundsShape::Sphere)
+	, BoundsScale(1.0f)
+	, bDirty(true)
+{
+}
+
+void FHasteOverlapFilter::SetShape(EHasteBoundsShape InShape, float InBoundsScale)
+{
+	if (Shape != InShape || BoundsScale != InBoundsScale) {
+		Shape = InShape;
+		BoundsScale = InBoundsScale;
+		MeshBoundsCache.Reset();
+		bDirty = true;
+	}
+}
+
+void FHasteOverlapFilter::MarkDirty()
+{
+	bDirty = true;
+}
+
+void FHasteOverlapFilter::SetMetadataCache(FHasteMeshMetadataCache* InMetadataCache)
+{
+	MetadataCache = InMetadataCache;
+	MeshBoundsCache.Reset();
+	bDirty = true;
+}
+
+void FHasteOverlapFilter::InvalidateMesh(UStaticMesh* Mesh)
+{
+	if (MeshBoundsCache.Remove(Mesh) > 0) {
+		bDirty = true;
+	}
+}
+
+void FHasteOverlapFilter::Update(UWorld* World)
+{
+	if (!bDirty && IndexedWorld.Get() == World) {
+		return;
+	}
+
+	Index.Reset();
+	ActorEntries.Reset();
+	IndexedWorld = World;
+	bDirty = false;
+	if (!World) {
+		return;
+	}
+
+	for (TActorIterator<AActor> It(World); It; ++It) {
+		AActor* Actor = *It;
+		if (Actor && Actor->ActorHasTag(FHasteTags::PlacedActor)) {
+			AddActor(Actor);
+		}
+	}
+}
+
+void FHasteOverlapFilter::UpdateActor(AActor* Actor)
+{
+	// A pending rebuild picks up the actor anyway
+	if (!Actor || bDirty || IndexedWorld.Get() != Actor->GetWorld()) {
+		return;
+	}
+
+	RemoveActor(Actor);
+	if (Actor->ActorHasTag(FHasteTags::PlacedActor)) {
+		AddActor(Actor);
+	}
+}
+
+void FHasteOverlapFilter::RemoveActor(AActor* Actor)
+{
+	if (!Actor || bDirty) {
+		return;
+	}
+
+	TArray<int32> Entries;
+	if (ActorEntries.RemoveAndCopyValue(Actor, Entries)) {
+		for (int32 EntryIndex : Entries) {
+			Index.Remove(EntryIndex);
+		}
+	}
+}
+
+void FHasteOverlapFilter::AddActor(AActor* Actor)
+{
+	TInlineComponentArray<UStaticMeshComponent*> Components;
+	Actor->GetComponents(Components);
+	for (UStaticMeshComponent* Component : Components) {
+		UStaticMesh* Mesh = Component->GetStaticMesh();
+		if (!Mesh) continue;
+
+		if (UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component)) {
+			const int32 NumInstances = InstancedComponent->GetInstanceCount();
+			for (int32 InstanceIndex = 0; InstanceIndex < NumInstances; InstanceIndex++) {
+				FTransform InstanceTransform;
+				InstancedComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, true);
+				AddPlacement(Mesh, InstanceTransform, InstancedComponent, InstanceIndex);
+			}
+		}
+		else {
+			AddPlacement(Mesh, Component->GetComponentTransform(), Component);
+		}
+	}
+}
+
+const FHasteMeshBounds& FHasteOverlapFilter::GetMeshBounds(UStaticMesh* Mesh)
+{
+	FHasteMeshBounds* Bounds = MeshBoundsCache.Find(Mesh);
+	if (!Bounds) {
+		Bounds = &MeshBoundsCache.Add(Mesh, MetadataCache
+			? FHasteMeshBounds::Create(MetadataCache->Get(Mesh).Bounds, Shape)
+			: FHasteMeshBounds::Create(Mesh, Shape));
+	}
+	return *Bounds;
+}
+
+FHasteSpatialEntry FHasteOverlapFilter::CreateEntry(UStaticMesh* Mesh, const FTransform& Transform)
+{
+	FHasteSpatialEntry Entry;
+	Entry.Mesh = Mesh;
+	Entry.Transform = Transform;
+	Entry.Bounds = GetMeshBounds(Mesh).ToWorld(Transform, BoundsScale);
+	Entry.BoundingBox = Entry.Bounds.GetBoundingBox();
+	return Entry;
+}
+
+bool FHasteOverlapFilter::OverlapsIndex(const FHasteSpatialIndex& InIndex, const FHasteSpatialEntry& Entry, const FHitResult* SurfaceHit) const
+{
+	TArray<int32> Nearby;
+	InIndex.Query(Entry.BoundingBox, Nearby);
+	for (int32 NearbyIndex : Nearby) {
+		const FHasteSpatialEntry& Other = InIndex.GetEntry(NearbyIndex);
+
+		// Meshes are allowed to rest on other placements
+		if (SurfaceHit && Other.Component.IsValid() && Other.Component == SurfaceHit->Component
+			&& (Other.InstanceIndex == INDEX_NONE || Other.InstanceIndex == SurfaceHit->Item)) {
+			continue;
+		}
+
+		if (Entry.Bounds.Overlaps(Other.Bounds)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FHasteOverlapFilter::IsOverlapping(const FHastePlacementCandidate& Candidate)
+{
+	if (!Candidate.Mesh) {
+		return false;
+	}
+	return OverlapsIndex(Index, CreateEntry(Candidate.Mesh, Candidate.Transform), &Candidate.Hit);
+}
+
+void FHasteOverlapFilter::FilterCandidates(TArray<FHastePlacementCandidate>& Candidates)
+{
+	// Accepted candidates are not committed yet, so they are tracked in a separate index to reject overlaps within the batch
+	FHasteSpatialIndex AcceptedIndex;
+	int32 NumAccepted = 0;
+	for (int32 i = 0; i < Candidates.Num(); i++) {
+		const FHastePlacementCandidate& Candidate = Candidates[i];
+		if (!Candidate.Mesh) continue;
+
+		const FHasteSpatialEntry Entry = CreateEntry(Candidate.Mesh, Candidate.Transform);
+		if (OverlapsIndex(Index, Entry, &Candidate.Hit) || OverlapsIndex(AcceptedIndex, Entry, nullptr)) {
+			continue;
+		}
+
+		AcceptedIndex.Add(Entry);
+		if (NumAccepted != i) {
+			Candidates[NumAccepted] = Candidate;
+		}
+		NumAccepted++;
+	}
+	Candidates.SetNum(NumAccepted, false);
+}
+
+void FHasteOverlapFilter::AddPlacement(UStaticMesh* Mesh, const FTransform& Transform, UPrimitiveComponent* Component, int32 InstanceIndex)
+{
+	if (!Mesh) {
+		return;
+	}
+
+	FHasteSpatialEntry Entry = CreateEntry(Mesh, Transform);
+	Entry.Component = Component;
+	Entry.InstanceIndex = InstanceIndex;
+	const int32 EntryIndex = Index.Add(Entry);
+	if (AActor* Owner = Component ? Component->GetOwner() : nullptr) {
+		ActorEntries.FindOrAdd(Owner).Add(EntryIndex);
+	}
+}
+
+int32 FHasteOverlapFilter::CountInSphere(const FVector& Center, float Radius) const
+{
+	TArray<int32> Nearby;
+	Index.Query(FBox(Center - FVector(Radius), Center + FVector(Radius)), Nearby);
+
+	int32 Count = 0;
+	const float RadiusSq = FMath::Square(Radius);
+	for (int32 NearbyIndex : Nearby) {
+		if (FVector::DistSquared(Index.GetEntry(NearbyIndex).Transform.GetLocation(), Center) <= RadiusSq) {
+			Count++;
+		}
+	}
+	return Count;
+}
+
+bool FHasteOverlapFilter::HasPlacementInColumn(const FVector& Start, const FVector& End, float Radius) const
+{
+	const FVector Extent(Radius, Radius, 0);
+	TArray<int32> Nearby;
+	Index.Query(FBox(Start.ComponentMin(End) - Extent, Start.ComponentMax(End) + Extent), Nearby);
+
+	const FVector2D Column(Start);
+	const float MinZ = FMath::Min(Start.Z, End.Z);
+	const float MaxZ = FMath::Max(Start.Z, End.Z);
+	const float RadiusSq = FMath::Square(Radius);
+	for (int32 NearbyIndex : Nearby) {
+		const FVector Location = Index.GetEntry(NearbyIndex).Transform.GetLocation();
+		if (Location.Z >= MinZ && Location.Z <= MaxZ && FVector2D::DistSquared(FVector2D(Location), Column) <= RadiusSq) {
+			return true;
+		}
+	}
+	return false;
+}
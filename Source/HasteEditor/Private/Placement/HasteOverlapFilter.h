@@ -0,0 +1,72 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "HastePlacement.h"
+#include "HasteSpatialIndex.h"
+
+class FHasteMeshMetadataCache;
+
+/**
+ * Rejects placements that would interpenetrate meshes already placed by Haste.
+ * Placed meshes are approximated with simplified bounds and kept in a spatial index,
+ * so no physics overlap queries are issued
+ */
+class FHasteOverlapFilter
+{
+public:
+	FHasteOverlapFilter();
+
+	/** Changes the shape used to approximate the meshes. Rebuilds the index on the next update if the shape changed */
+	void SetShape(EHasteBoundsShape InShape, float InBoundsScale);
+
+	/** Flags the index to be rebuilt from the world on the next update */
+	void MarkDirty();
+
+	/** Reads the mesh bounds from the metadata cache instead of the meshes. The cache must outlive the filter */
+	void SetMetadataCache(FHasteMeshMetadataCache* InMetadataCache);
+
+	/** Drops the cached bounds of the mesh (e.g. after a reimport) and rebuilds the index on the next update */
+	void InvalidateMesh(UStaticMesh* Mesh);
+
+	/** Rebuilds the index from the Haste placements in the world, if required */
+	void Update(UWorld* World);
+
+	/** Re-registers the placements of a single actor (e.g. after it was moved or its instances changed) */
+	void UpdateActor(AActor* Actor);
+
+	/** Unregisters the placements of an actor that is being deleted */
+	void RemoveActor(AActor* Actor);
+
+	/** Checks if the candidate interpenetrates an existing placement. The surface the candidate rests on is ignored */
+	bool IsOverlapping(const FHastePlacementCandidate& Candidate);
+
+	/** Removes the candidates that overlap existing placements or an earlier candidate in the list */
+	void FilterCandidates(TArray<FHastePlacementCandidate>& Candidates);
+
+	/** Registers a committed placement */
+	void AddPlacement(UStaticMesh* Mesh, const FTransform& Transform, UPrimitiveComponent* Component, int32 InstanceIndex = INDEX_NONE);
+
+	/** Number of placements whose origin lies within the sphere */
+	int32 CountInSphere(const FVector& Center, float Radius) const;
+
+	/** Checks if a placement has its origin within the radius of a vertical segment, measured horizontally */
+	bool HasPlacementInColumn(const FVector& Start, const FVector& End, float Radius) const;
+
+private:
+	void AddActor(AActor* Actor);
+	const FHasteMeshBounds& GetMeshBounds(UStaticMesh* Mesh);
+	FHasteSpatialEntry CreateEntry(UStaticMesh* Mesh, const FTransform& Transform);
+	bool OverlapsIndex(const FHasteSpatialIndex& InIndex, const FHasteSpatialEntry& Entry, const FHitResult* SurfaceHit) const;
+
+private:
+	FHasteSpatialIndex Index;
+	TMap<TWeakObjectPtr<UStaticMesh>, FHasteMeshBounds> MeshBoundsCache;
+
+	/** The index entries of each actor, so a single actor can be updated without a rebuild */
+	TMap<TWeakObjectPtr<AActor>, TArray<int32>> ActorEntries;
+	TWeakObjectPtr<UWorld> IndexedWorld;
+	FHasteMeshMetadataCache* MetadataCache;
+
+	EHasteBoundsShape Shape;
+	float BoundsScale;
+	bool bDirty;
+};
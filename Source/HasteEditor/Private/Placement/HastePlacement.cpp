@@ -0,0 +1,16 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HastePlacement.h"
+
+const FName FHasteTags::PlacedActor(TEXT("HastePlaced"));
+const FName FHasteTags::InstanceContainer(TEXT("HasteInstances"));
+const FName FHasteTags::ScatterComponent(TEXT("HasteScatter"));
+
+void FHasteSurfaceStats::Add(const FHitResult& Hit)
+{
+	MinHeight = FMath::Min(MinHeight, Hit.ImpactPoint.Z);
+	MaxHeight = FMath::Max(MaxHeight, Hit.ImpactPoint.Z);
+	MinNormalZ = FMath::Min(MinNormalZ, Hit.ImpactNormal.Z);
+	MaxNormalZ = FMath::Max(MaxNormalZ, Hit.ImpactNormal.Z);
+	PhysMaterials.AddUnique(Hit.PhysMaterial);
+}
@@ -0,0 +1,70 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "HastePlacement.generated.h"
+
+/** Simplified shape used to approximate a mesh when testing placements against each other */
+UENUM()
+enum class EHasteBoundsShape : uint8
+{
+	Sphere,
+	Capsule,
+	Box
+};
+
+/** Actor tags used to recognize content created by Haste */
+struct FHasteTags
+{
+	/** Added to every actor placed by the Haste mode */
+	static const FName PlacedActor;
+
+	/** Added to the actors that hold the instanced meshes placed by Haste */
+	static const FName InstanceContainer;
+
+	/** Added to the instanced components that only hold scattered meshes */
+	static const FName ScatterComponent;
+};
+
+/** Range of the hit attributes the filters read, over the surface under an area */
+struct FHasteSurfaceStats
+{
+	FHasteSurfaceStats()
+		: MinHeight(MAX_flt)
+		, MaxHeight(-MAX_flt)
+		, MinNormalZ(MAX_flt)
+		, MaxNormalZ(-MAX_flt)
+	{
+	}
+
+	void Add(const FHitResult& Hit);
+
+	float MinHeight;
+	float MaxHeight;
+	float MinNormalZ;
+	float MaxNormalZ;
+
+	/** Every physical material that was hit, including none */
+	TArray<TWeakObjectPtr<UPhysicalMaterial>> PhysMaterials;
+};
+
+/** A potential placement that has not been committed to the level yet */
+struct FHastePlacementCandidate
+{
+	FHastePlacementCandidate()
+		: Mesh(nullptr)
+		, Transform(FTransform::Identity)
+		, SampleIndex(INDEX_NONE)
+	{
+	}
+
+	/** The mesh that would be placed */
+	UStaticMesh* Mesh;
+
+	/** Transform of the placement before the transformers are applied */
+	FTransform Transform;
+
+	/** The surface hit this candidate was projected on to */
+	FHitResult Hit;
+
+	/** Index of the sample that produced this candidate, within a bulk placement */
+	int32 SampleIndex;
+};
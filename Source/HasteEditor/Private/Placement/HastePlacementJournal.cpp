@@ -0,0 +1,629 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HastePlacementJournal.h"
+#include "HastePlacement.h"
+#include "HasteInstanceContainer.h"
+#include "HasteCullDistance.h"
+#include "HasteProjectSettings.h"
+#include "ScopedTransaction.h"
+#include "SNotificationList.h"
+#include "NotificationManager.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
+#define LOCTEXT_NAMESPACE "HastePlacementJournal"
+
+#define HASTE_JOURNAL_MAGIC 0x4C4E4A48
+#define HASTE_JOURNAL_VERSION 2
+
+/** The pending records are written at least this often, in seconds */
+#define HASTE_JOURNAL_WRITE_INTERVAL 0.25f
+
+/** Pending records are written right away once they grow past this size, in bytes */
+#define HASTE_JOURNAL_WRITE_SIZE (64 * 1024)
+
+/** Erased placements are matched to the replayed ones within this distance */
+#define HASTE_JOURNAL_MATCH_TOLERANCE 0.1f
+
+namespace EHasteJournalRecord
+{
+	enum Type : uint8
+	{
+		/** The map of the records that follow */
+		Map,
+
+		/** Assigns an index to a mesh or level path */
+		Name,
+
+		Place,
+		Erase,
+
+		/** Starts a journal transaction, on top of the current one */
+		Transaction,
+
+		/** Makes an earlier transaction current, after an undo or redo */
+		Head
+	};
+}
+
+FHastePlacementJournal* FHastePlacementJournal::Instance = nullptr;
+
+void FHastePlacementJournal::Initialize()
+{
+	if (!Instance) {
+		Instance = new FHastePlacementJournal();
+	}
+}
+
+void FHastePlacementJournal::Shutdown()
+{
+	delete Instance;
+	Instance = nullptr;
+}
+
+FHastePlacementJournal* FHastePlacementJournal::Get()
+{
+	return Instance;
+}
+
+FHastePlacementJournal::FHastePlacementJournal()
+	: TimeSinceWrite(0)
+	, bHeaderWritten(false)
+	, OpenUndo(nullptr)
+	, OpenUndoQueueLength(0)
+	, OpenTransaction(0)
+	, DeferredTransaction(0)
+	, HeadTransaction(0)
+	, NextTransaction(1)
+	, bUndoClientRegistered(false)
+{
+	const FString JournalDir = FPaths::Combine(*FPaths::GameSavedDir(), TEXT("Haste"));
+	JournalFilename = FPaths::Combine(*JournalDir, TEXT("PlacementJournal.bin"));
+	RecoveryFilename = FPaths::Combine(*JournalDir, TEXT("PlacementJournal.recovered"));
+
+	// A journal that is still around was neither truncated by a save nor deleted by a normal exit, so the previous session
+	// crashed before its placements were saved. It is moved aside, so this session starts a journal of its own
+	IFileManager& FileManager = IFileManager::Get();
+	if (FileManager.FileSize(*JournalFilename) > 0) {
+		FileManager.Move(*RecoveryFilename, *JournalFilename, true);
+	}
+	else {
+		FileManager.Delete(*JournalFilename, false, false, true);
+	}
+	if (!ReadEntries(RecoveryFilename, RecoveryMap, RecoveryEntries) || RecoveryEntries.Num() == 0) {
+		DiscardRecovery();
+	}
+
+	FEditorDelegates::OnMapOpened.AddRaw(this, &FHastePlacementJournal::OnMapOpened);
+	FEditorDelegates::MapChange.AddRaw(this, &FHastePlacementJournal::OnMapChange);
+	FEditorDelegates::PostSaveWorld.AddRaw(this, &FHastePlacementJournal::OnPostSaveWorld);
+
+	UndoMarker = NewObject<UHasteJournalUndoMarker>(GetTransientPackage(), NAME_None, RF_Transactional);
+	UndoMarker->Transaction = 0;
+}
+
+FHastePlacementJournal::~FHastePlacementJournal()
+{
+	FEditorDelegates::OnMapOpened.RemoveAll(this);
+	FEditorDelegates::MapChange.RemoveAll(this);
+	FEditorDelegates::PostSaveWorld.RemoveAll(this);
+	if (GEngine) {
+		GEngine->OnLevelActorDeleted().Remove(LevelActorDeletedDelegate);
+	}
+	if (GEditor && bUndoClientRegistered) {
+		GEditor->UnregisterForUndo(this);
+	}
+
+	// The module only shuts down when the editor exits normally, and the unsaved placements were then kept or
+	// discarded by the user. Only a crash leaves the journal behind
+	Truncate();
+}
+
+void FHastePlacementJournal::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(UndoMarker);
+}
+
+void FHastePlacementJournal::BeginRecord(ULevel* Level, FMemoryWriter& Writer)
+{
+	if (!bHeaderWritten) {
+		uint32 Magic = HASTE_JOURNAL_MAGIC;
+		uint32 Version = HASTE_JOURNAL_VERSION;
+		Writer << Magic << Version;
+		bHeaderWritten = true;
+	}
+
+	// The map name is only built again when the world changes
+	UWorld* World = Level ? Level->OwningWorld : nullptr;
+	if (World && World != JournaledWorld.Get()) {
+		FString Map = World->GetOutermost()->GetName();
+		if (Map != JournaledMap) {
+			uint8 MapRecord = EHasteJournalRecord::Map;
+			Writer << MapRecord << Map;
+			JournaledMap = Map;
+		}
+		JournaledWorld = World;
+	}
+}
+
+int32 FHastePlacementJournal::GetNameId(const FString& Name, FMemoryWriter& Writer)
+{
+	if (const int32* Id = NameIds.Find(Name)) {
+		return *Id;
+	}
+
+	int32 Id = NameIds.Num();
+	NameIds.Add(Name, Id);
+	uint8 NameRecord = EHasteJournalRecord::Name;
+	FString NameCopy = Name;
+	Writer << NameRecord << Id << NameCopy;
+	return Id;
+}
+
+int32 FHastePlacementJournal::GetMeshNameId(UStaticMesh* Mesh, FMemoryWriter& Writer)
+{
+	if (const int32* Id = ObjectNameIds.Find(Mesh)) {
+		return *Id;
+	}
+	const int32 Id = GetNameId(Mesh->GetPathName(), Writer);
+	ObjectNameIds.Add(Mesh, Id);
+	return Id;
+}
+
+int32 FHastePlacementJournal::GetLevelNameId(ULevel* Level, FMemoryWriter& Writer)
+{
+	if (const int32* Id = ObjectNameIds.Find(Level)) {
+		return *Id;
+	}
+	const int32 Id = GetNameId(Level->GetOutermost()->GetName(), Writer);
+	ObjectNameIds.Add(Level, Id);
+	return Id;
+}
+
+int32 FHastePlacementJournal::GetTransaction()
+{
+	if (!GUndo || !GEditor || !GEditor->Trans) {
+		return DeferredTransaction;
+	}
+
+	const int32 QueueLength = GEditor->Trans->GetQueueLength();
+	if (GUndo != OpenUndo || QueueLength != OpenUndoQueueLength || OpenTransaction == 0) {
+		OpenUndo = GUndo;
+		OpenUndoQueueLength = QueueLength;
+		OpenTransaction = NextTransaction++;
+
+		// The marker is saved into the editor transaction before it changes, so undoing it restores the previous transaction
+		UndoMarker->Modify(false);
+		UndoMarker->Transaction = OpenTransaction;
+
+		FMemoryWriter Writer(PendingData);
+		Writer.Seek(PendingData.Num());
+		BeginRecord(nullptr, Writer);
+		uint8 RecordType = EHasteJournalRecord::Transaction;
+		int32 Transaction = OpenTransaction;
+		int32 ParentTransaction = HeadTransaction;
+		Writer << RecordType << Transaction << ParentTransaction;
+		HeadTransaction = OpenTransaction;
+	}
+	return OpenTransaction;
+}
+
+void FHastePlacementJournal::RecordPlacement(UStaticMesh* Mesh, const FTransform& Transform, ULevel* Level, bool bInstanced, int32 Seed)
+{
+	RecordEntry(EHasteJournalRecord::Place, Mesh, Transform, Level, bInstanced, Seed);
+}
+
+void FHastePlacementJournal::RecordErase(UStaticMesh* Mesh, const FTransform& Transform, ULevel* Level, bool bInstanced)
+{
+	RecordEntry(EHasteJournalRecord::Erase, Mesh, Transform, Level, bInstanced, 0);
+}
+
+void FHastePlacementJournal::RecordEntry(uint8 RecordType, UStaticMesh* Mesh, const FTransform& Transform, ULevel* Level, bool bInstanced, int32 Seed)
+{
+	// Changes made by an undo or redo are covered by the head record written after it
+	if (!Mesh || !Level || GIsTransacting) {
+		return;
+	}
+
+	// Starting a transaction writes a record of its own, so it goes first
+	int32 Transaction = GetTransaction();
+
+	FMemoryWriter Writer(PendingData);
+	Writer.Seek(PendingData.Num());
+
+	// Names go before the record that references them
+	BeginRecord(Level, Writer);
+	int32 MeshId = GetMeshNameId(Mesh, Writer);
+	int32 LevelId = GetLevelNameId(Level, Writer);
+
+	uint8 bInstancedValue = bInstanced ? 1 : 0;
+	FTransform TransformCopy = Transform;
+	Writer << RecordType << Transaction << MeshId << LevelId << bInstancedValue;
+	if (RecordType == EHasteJournalRecord::Place) {
+		Writer << Seed;
+	}
+	Writer << TransformCopy;
+}
+
+void FHastePlacementJournal::PostUndo(bool bSuccess)
+{
+	// The marker was restored with the rest of the transaction. It only changes when a journal transaction was undone or redone
+	OpenUndo = nullptr;
+	OpenTransaction = 0;
+	if (UndoMarker->Transaction != HeadTransaction) {
+		HeadTransaction = UndoMarker->Transaction;
+
+		FMemoryWriter Writer(PendingData);
+		Writer.Seek(PendingData.Num());
+		BeginRecord(nullptr, Writer);
+		uint8 RecordType = EHasteJournalRecord::Head;
+		int32 Transaction = HeadTransaction;
+		Writer << RecordType << Transaction;
+	}
+}
+
+void FHastePlacementJournal::Truncate()
+{
+	WaitForWrite();
+	File.Reset();
+	IFileManager::Get().Delete(*JournalFilename, false, false, true);
+
+	// Transaction numbers keep counting up, so a transaction that was open during the truncation still stands out
+	PendingData.Reset();
+	NameIds.Reset();
+	ObjectNameIds.Reset();
+	JournaledWorld.Reset();
+	JournaledMap.Reset();
+	bHeaderWritten = false;
+}
+
+void FHastePlacementJournal::Tick(float DeltaTime)
+{
+	// The journal is created before the engine, so the engine events are bound on the first tick
+	if (!LevelActorDeletedDelegate.IsValid() && GEngine) {
+		LevelActorDeletedDelegate = GEngine->OnLevelActorDeleted().AddRaw(this, &FHastePlacementJournal::OnLevelActorDeleted);
+	}
+	if (!bUndoClientRegistered && GEditor) {
+		GEditor->RegisterForUndo(this);
+		bUndoClientRegistered = true;
+	}
+	if (GEditor && !GEditor->IsTransactionActive()) {
+		OpenUndo = nullptr;
+		OpenTransaction = 0;
+	}
+
+	TimeSinceWrite += DeltaTime;
+	if (PendingData.Num() > 0 && (TimeSinceWrite >= HASTE_JOURNAL_WRITE_INTERVAL || PendingData.Num() >= HASTE_JOURNAL_WRITE_SIZE)) {
+		StartWrite();
+	}
+}
+
+TStatId FHastePlacementJournal::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FHastePlacementJournal, STATGROUP_Tickables);
+}
+
+void FHastePlacementJournal::StartWrite()
+{
+	if (PendingData.Num() == 0 || (WriteTask.IsValid() && !WriteTask.IsReady())) {
+		return;
+	}
+
+	WritingData = MoveTemp(PendingData);
+	PendingData.Reset();
+	TimeSinceWrite = 0;
+
+	// Only one write is in flight at a time, so the records reach the file in order
+	WriteTask = Async<void>(EAsyncExecution::ThreadPool, [this]() {
+		if (!File.IsValid()) {
+			File = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*JournalFilename, FILEWRITE_Append | FILEWRITE_AllowRead));
+		}
+		if (File.IsValid()) {
+			File->Serialize(WritingData.GetData(), WritingData.Num());
+			File->Flush();
+		}
+		WritingData.Reset();
+	});
+}
+
+void FHastePlacementJournal::WaitForWrite()
+{
+	if (WriteTask.IsValid()) {
+		WriteTask.Wait();
+		WriteTask = TFuture<void>();
+	}
+}
+
+bool FHastePlacementJournal::ReadEntries(const FString& Filename, FString& OutMap, TArray<FHasteJournalEntry>& OutEntries)
+{
+	OutMap.Reset();
+	OutEntries.Reset();
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename, FILEREAD_Silent)) {
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0, Version = 0;
+	Reader << Magic << Version;
+	if (Reader.IsError() || Magic != HASTE_JOURNAL_MAGIC || Version != HASTE_JOURNAL_VERSION) {
+		return false;
+	}
+
+	// The last record may have been cut short by the crash. Reading stops at the first incomplete record
+	TArray<FString> Names;
+	FString Map;
+	TArray<FHasteJournalEntry> Entries;
+	TMap<int32, int32> ParentTransactions;
+	int32 HeadTransaction = 0;
+	while (!Reader.AtEnd()) {
+		uint8 RecordType = 0;
+		Reader << RecordType;
+
+		if (RecordType == EHasteJournalRecord::Map) {
+			Reader << Map;
+		}
+		else if (RecordType == EHasteJournalRecord::Name) {
+			int32 Id = 0;
+			FString Name;
+			Reader << Id << Name;
+			if (!Reader.IsError() && Id == Names.Num()) {
+				Names.Add(Name);
+			}
+		}
+		else if (RecordType == EHasteJournalRecord::Place || RecordType == EHasteJournalRecord::Erase) {
+			FHasteJournalEntry Entry;
+			int32 MeshId = 0, LevelId = 0;
+			uint8 bInstanced = 0;
+			Entry.Seed = 0;
+			Entry.Transaction = 0;
+			Entry.bErase = RecordType == EHasteJournalRecord::Erase;
+			Reader << Entry.Transaction << MeshId << LevelId << bInstanced;
+			if (!Entry.bErase) {
+				Reader << Entry.Seed;
+			}
+			Reader << Entry.Transform;
+			if (!Reader.IsError() && Names.IsValidIndex(MeshId) && Names.IsValidIndex(LevelId)) {
+				Entry.bInstanced = bInstanced != 0;
+				Entry.MeshPath = Names[MeshId];
+				Entry.LevelPackage = Names[LevelId];
+				Entries.Add(Entry);
+				OutMap = Map;
+			}
+		}
+		else if (RecordType == EHasteJournalRecord::Transaction) {
+			int32 Transaction = 0, ParentTransaction = 0;
+			Reader << Transaction << ParentTransaction;
+			if (!Reader.IsError()) {
+				ParentTransactions.Add(Transaction, ParentTransaction);
+				HeadTransaction = Transaction;
+			}
+		}
+		else if (RecordType == EHasteJournalRecord::Head) {
+			int32 Transaction = 0;
+			Reader << Transaction;
+			if (!Reader.IsError()) {
+				HeadTransaction = Transaction;
+			}
+		}
+		else {
+			break;
+		}
+
+		if (Reader.IsError()) {
+			break;
+		}
+	}
+
+	// Only the transactions from the current one down to the first are in effect. The others were undone, or were
+	// redo history that a later transaction replaced. A transaction started before the journal was truncated ends the chain
+	TSet<int32> LiveTransactions;
+	for (int32 Transaction = HeadTransaction; Transaction != 0 && !LiveTransactions.Contains(Transaction);) {
+		LiveTransactions.Add(Transaction);
+		const int32* ParentTransaction = ParentTransactions.Find(Transaction);
+		if (!ParentTransaction) break;
+		Transaction = *ParentTransaction;
+	}
+	for (const FHasteJournalEntry& Entry : Entries) {
+		if (Entry.Transaction == 0 || LiveTransactions.Contains(Entry.Transaction)) {
+			OutEntries.Add(Entry);
+		}
+	}
+	return true;
+}
+
+void FHastePlacementJournal::OnMapOpened(const FString& Filename, bool bAsTemplate)
+{
+	FString PackageName;
+	if (RecoveryEntries.Num() > 0 && !RecoveryNotification.IsValid() && !bAsTemplate
+		&& FPackageName::TryConvertFilenameToLongPackageName(Filename, PackageName) && PackageName == RecoveryMap) {
+		OfferRecovery();
+	}
+}
+
+void FHastePlacementJournal::OnMapChange(uint32 MapChangeFlags)
+{
+	// A new map replaces the edited one, so its unsaved placements were discarded on purpose
+	if (MapChangeFlags & MapChangeEventFlags::NewMap) {
+		Truncate();
+	}
+}
+
+void FHastePlacementJournal::OnPostSaveWorld(uint32 SaveFlags, UWorld* World, bool bSuccess)
+{
+	// A Save As gives the journaled world a new name
+	if (bSuccess && World && (World == JournaledWorld.Get() || World->GetOutermost()->GetName() == JournaledMap)) {
+		Truncate();
+	}
+}
+
+void FHastePlacementJournal::OnLevelActorDeleted(AActor* Actor)
+{
+	// Placed actors are erased by the user as well as by Haste, so their deletion is recorded here for both
+	AStaticMeshActor* MeshActor = Cast<AStaticMeshActor>(Actor);
+	if (MeshActor && MeshActor->ActorHasTag(FHasteTags::PlacedActor) && MeshActor->GetWorld() && MeshActor->GetWorld()->WorldType == EWorldType::Editor) {
+		RecordErase(MeshActor->GetStaticMeshComponent()->GetStaticMesh(), MeshActor->GetActorTransform(), MeshActor->GetLevel(), false);
+	}
+}
+
+void FHastePlacementJournal::OfferRecovery()
+{
+	FNotificationInfo Info(FText::Format(LOCTEXT("RecoveryPrompt", "Haste found {0} placement changes to {1} that were not saved when the editor closed"),
+		FText::AsNumber(RecoveryEntries.Num()), FText::FromString(FPackageName::GetShortName(RecoveryMap))));
+	Info.bFireAndForget = false;
+	Info.ButtonDetails.Add(FNotificationButtonInfo(
+		LOCTEXT("ReplayButton", "Replay"),
+		LOCTEXT("ReplayButtonTooltip", "Apply the unsaved placements to the level"),
+		FSimpleDelegate::CreateRaw(this, &FHastePlacementJournal::OnReplayClicked),
+		SNotificationItem::CS_Pending));
+	Info.ButtonDetails.Add(FNotificationButtonInfo(
+		LOCTEXT("DiscardButton", "Discard"),
+		LOCTEXT("DiscardButtonTooltip", "Delete the unsaved placements"),
+		FSimpleDelegate::CreateRaw(this, &FHastePlacementJournal::OnDiscardClicked),
+		SNotificationItem::CS_Pending));
+	RecoveryNotification = FSlateNotificationManager::Get().AddNotification(Info);
+	if (RecoveryNotification.IsValid()) {
+		RecoveryNotification->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+}
+
+void FHastePlacementJournal::OnReplayClicked()
+{
+	UWorld* World = GEditor->GetEditorWorldContext().World();
+	const int32 NumReplayed = World ? ReplayEntries(World, RecoveryEntries) : 0;
+	if (RecoveryNotification.IsValid()) {
+		RecoveryNotification->SetText(FText::Format(LOCTEXT("RecoveryReplayed", "Replayed {0} placement changes"), FText::AsNumber(NumReplayed)));
+		RecoveryNotification->SetCompletionState(SNotificationItem::CS_Success);
+		RecoveryNotification->ExpireAndFadeout();
+		RecoveryNotification.Reset();
+	}
+	DiscardRecovery();
+}
+
+void FHastePlacementJournal::OnDiscardClicked()
+{
+	if (RecoveryNotification.IsValid()) {
+		RecoveryNotification->SetCompletionState(SNotificationItem::CS_None);
+		RecoveryNotification->ExpireAndFadeout();
+		RecoveryNotification.Reset();
+	}
+	DiscardRecovery();
+}
+
+void FHastePlacementJournal::DiscardRecovery()
+{
+	RecoveryEntries.Reset();
+	RecoveryMap.Reset();
+	IFileManager::Get().Delete(*RecoveryFilename, false, false, true);
+}
+
+int32 FHastePlacementJournal::ReplayEntries(UWorld* World, const TArray<FHasteJournalEntry>& Entries)
+{
+	const FScopedTransaction Transaction(LOCTEXT("HasteReplayJournal", "Replay Haste Placements"));
+	const bool bApplyCullDistance = GetDefault<UHasteProjectSettings>()->bApplyCullDistanceOnPlacement;
+
+	// Consecutive instances of a mesh are added in one batch. The batches are flushed before an erase, which may refer to them
+	TMap<UHierarchicalInstancedStaticMeshComponent*, TArray<FTransform>> PendingInstances;
+	auto FlushInstances = [&]() {
+		for (auto& Pending : PendingInstances) {
+			FHasteInstanceContainers::AddInstances(Pending.Key, Pending.Value);
+			if (bApplyCullDistance) {
+				FHasteCullDistance::ApplyToComponent(Pending.Key);
+			}
+		}
+		PendingInstances.Reset();
+	};
+
+	int32 NumReplayed = 0;
+	for (const FHasteJournalEntry& Entry : Entries) {
+		UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, *Entry.MeshPath, nullptr, LOAD_None, nullptr);
+		ULevel* Level = nullptr;
+		for (ULevel* WorldLevel : World->GetLevels()) {
+			if (WorldLevel && WorldLevel->GetOutermost()->GetName() == Entry.LevelPackage) {
+				Level = WorldLevel;
+				break;
+			}
+		}
+		if (!Mesh || !Level) continue;
+
+		if (Entry.bInstanced && !Entry.bErase) {
+			AActor* Container = FHasteInstanceContainers::FindOrCreateContainer(Level);
+			if (UHierarchicalInstancedStaticMeshComponent* Component = FHasteInstanceContainers::FindOrCreateComponent(Container, Mesh)) {
+				PendingInstances.FindOrAdd(Component).Add(Entry.Transform);
+			}
+		}
+		else if (Entry.bInstanced) {
+			FlushInstances();
+			AActor* Container = FHasteInstanceContainers::FindOrCreateContainer(Level);
+			UHierarchicalInstancedStaticMeshComponent* Component = FHasteInstanceContainers::FindOrCreateComponent(Container, Mesh);
+			const int32 NumInstances = Component ? Component->GetInstanceCount() : 0;
+			for (int32 InstanceIndex = NumInstances - 1; InstanceIndex >= 0; InstanceIndex--) {
+				FTransform InstanceTransform;
+				if (Component->GetInstanceTransform(InstanceIndex, InstanceTransform, true)
+					&& InstanceTransform.GetLocation().Equals(Entry.Transform.GetLocation(), HASTE_JOURNAL_MATCH_TOLERANCE)) {
+					TArray<int32> InstanceIndices;
+					InstanceIndices.Add(InstanceIndex);
+					FHasteInstanceContainers::RemoveInstances(Component, InstanceIndices);
+					break;
+				}
+			}
+		}
+		else if (!Entry.bErase) {
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.OverrideLevel = Level;
+			AStaticMeshActor* MeshActor = World->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Entry.Transform, SpawnParams);
+			if (!MeshActor) continue;
+
+			FActorLabelUtilities::SetActorLabelUnique(MeshActor, Mesh->GetName());
+			MeshActor->Tags.Add(FHasteTags::PlacedActor);
+			MeshActor->GetStaticMeshComponent()->SetStaticMesh(Mesh);
+			if (bApplyCullDistance) {
+				FHasteCullDistance::ApplyToComponent(MeshActor->GetStaticMeshComponent());
+			}
+			MeshActor->ReregisterAllComponents();
+		}
+		else {
+			for (AActor* Actor : Level->Actors) {
+				AStaticMeshActor* MeshActor = Cast<AStaticMeshActor>(Actor);
+				if (MeshActor && !MeshActor->IsPendingKill() && MeshActor->ActorHasTag(FHasteTags::PlacedActor)
+					&& MeshActor->GetStaticMeshComponent()->GetStaticMesh() == Mesh
+					&& MeshActor->GetActorLocation().Equals(Entry.Transform.GetLocation(), HASTE_JOURNAL_MATCH_TOLERANCE)) {
+					World->EditorDestroyActor(MeshActor, true);
+					break;
+				}
+			}
+		}
+
+		// The replayed changes are recorded again, so they survive another crash before the level is saved.
+		// Deleted actors were recorded by the deletion event
+		if (Entry.bErase) {
+			if (Entry.bInstanced) {
+				RecordErase(Mesh, Entry.Transform, Level, true);
+			}
+		}
+		else {
+			RecordPlacement(Mesh, Entry.Transform, Level, Entry.bInstanced, Entry.Seed);
+		}
+		NumReplayed++;
+	}
+	FlushInstances();
+	return NumReplayed;
+}
+
+FHasteScopedJournalTransaction::FHasteScopedJournalTransaction(int32 Transaction)
+	: PreviousTransaction(0)
+{
+	if (FHastePlacementJournal* Journal = FHastePlacementJournal::Get()) {
+		PreviousTransaction = Journal->DeferredTransaction;
+		Journal->DeferredTransaction = Transaction;
+	}
+}
+
+FHasteScopedJournalTransaction::~FHasteScopedJournalTransaction()
+{
+	if (FHastePlacementJournal* Journal = FHastePlacementJournal::Get()) {
+		Journal->DeferredTransaction = PreviousTransaction;
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
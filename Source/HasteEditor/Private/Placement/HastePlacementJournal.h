@@ -0,0 +1,179 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "TickableEditorObject.h"
+#include "EditorUndoClient.h"
+#include "Async.h"
+#include "HastePlacementJournal.generated.h"
+
+class SNotificationItem;
+
+/**
+ * Transactional value that follows the undo history. Every journal transaction saves it into the editor transaction
+ * before changing it, so after an undo or redo it holds the journal transaction that is current again
+ */
+UCLASS()
+class UHasteJournalUndoMarker : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	int32 Transaction;
+};
+
+/** A placement or erase read back from a journal */
+struct FHasteJournalEntry
+{
+	bool bErase;
+	bool bInstanced;
+	int32 Seed;
+
+	/** The journal transaction the change was made in. Zero if it was made outside of any transaction */
+	int32 Transaction;
+	FString MeshPath;
+	FString LevelPackage;
+	FTransform Transform;
+};
+
+/**
+ * Append-only log of the placements and erases done by Haste since the level was last saved, so the work
+ * survives an editor crash. Records are encoded on the game thread into a small buffer, and the buffer is
+ * appended to disk by a background task a few times per second. A journal left behind by a crash is offered
+ * for replay the next time its map is opened. The journal is deleted when the editor exits normally.
+ *
+ * Records are tagged with the editor transaction they were made in, and every undo or redo records which
+ * transaction is current, so a replay skips the changes that were undone
+ */
+class FHastePlacementJournal : public FTickableEditorObject, public FGCObject, public FEditorUndoClient
+{
+public:
+	/** Created and destroyed by the module */
+	static void Initialize();
+	static void Shutdown();
+
+	/** The journal of the editor session. Null before the module started */
+	static FHastePlacementJournal* Get();
+
+	/** Records a committed placement. Instanced placements live in the Haste container of the level */
+	void RecordPlacement(UStaticMesh* Mesh, const FTransform& Transform, ULevel* Level, bool bInstanced, int32 Seed);
+
+	/** Records a placement that was removed */
+	void RecordErase(UStaticMesh* Mesh, const FTransform& Transform, ULevel* Level, bool bInstanced);
+
+	/** Forgets everything recorded so far, once the level was saved or discarded */
+	void Truncate();
+
+	/**
+	 * Returns the journal transaction of the editor transaction in progress, starting one the first time it is seen.
+	 * Outside of a transaction, returns the transaction set by FHasteScopedJournalTransaction, or zero
+	 */
+	int32 GetTransaction();
+
+	/** FTickableEditorObject interface */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return true; }
+	virtual TStatId GetStatId() const override;
+
+	/** FGCObject interface */
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+	/** FEditorUndoClient interface */
+	virtual void PostUndo(bool bSuccess) override;
+	virtual void PostRedo(bool bSuccess) override { PostUndo(bSuccess); }
+
+private:
+	FHastePlacementJournal();
+	virtual ~FHastePlacementJournal();
+
+	/** Writes the file header and the map of the level, when they were not written yet. Only the header without a level */
+	void BeginRecord(ULevel* Level, FMemoryWriter& Writer);
+
+	/** Encodes a placement or erase */
+	void RecordEntry(uint8 RecordType, UStaticMesh* Mesh, const FTransform& Transform, ULevel* Level, bool bInstanced, int32 Seed);
+
+	/** Returns the index of the path, writing a name record the first time it is seen */
+	int32 GetNameId(const FString& Name, FMemoryWriter& Writer);
+
+	/** Same as GetNameId, for the path of a mesh or the package of a level, without building the path again on every record */
+	int32 GetMeshNameId(UStaticMesh* Mesh, FMemoryWriter& Writer);
+	int32 GetLevelNameId(ULevel* Level, FMemoryWriter& Writer);
+
+	/** Hands the pending records to the writer task, unless a write is still in flight */
+	void StartWrite();
+	void WaitForWrite();
+
+	static bool ReadEntries(const FString& Filename, FString& OutMap, TArray<FHasteJournalEntry>& OutEntries);
+	int32 ReplayEntries(UWorld* World, const TArray<FHasteJournalEntry>& Entries);
+
+	void OfferRecovery();
+	void OnReplayClicked();
+	void OnDiscardClicked();
+	void DiscardRecovery();
+
+	void OnMapOpened(const FString& Filename, bool bAsTemplate);
+	void OnMapChange(uint32 MapChangeFlags);
+	void OnPostSaveWorld(uint32 SaveFlags, UWorld* World, bool bSuccess);
+	void OnLevelActorDeleted(AActor* Actor);
+
+private:
+	FString JournalFilename;
+	FString RecoveryFilename;
+	FDelegateHandle LevelActorDeletedDelegate;
+
+	/** Records encoded since the last write */
+	TArray<uint8> PendingData;
+	float TimeSinceWrite;
+
+	/** Owned by the writer task while it runs */
+	TArray<uint8> WritingData;
+	TUniquePtr<FArchive> File;
+	TFuture<void> WriteTask;
+
+	/** Mesh and level paths are written once per file, and referenced by index afterwards */
+	TMap<FString, int32> NameIds;
+	TMap<TWeakObjectPtr<UObject>, int32> ObjectNameIds;
+	TWeakObjectPtr<UWorld> JournaledWorld;
+	FString JournaledMap;
+	bool bHeaderWritten;
+
+	/**
+	 * The editor transaction the open journal transaction belongs to. The transaction object can be reused once the
+	 * undo buffer is trimmed, so the length of the undo queue is compared too, and the open transaction is forgotten
+	 * after every undo or redo and on every tick outside of a transaction
+	 */
+	const ITransaction* OpenUndo;
+	int32 OpenUndoQueueLength;
+	int32 OpenTransaction;
+
+	/** The transaction the records outside of any editor transaction belong to. See FHasteScopedJournalTransaction */
+	int32 DeferredTransaction;
+
+	/** The current journal transaction, as last recorded to the file */
+	int32 HeadTransaction;
+	int32 NextTransaction;
+	UHasteJournalUndoMarker* UndoMarker;
+	bool bUndoClientRegistered;
+
+	/** Entries of a journal left behind by a crash, waiting for the user to replay or discard them */
+	FString RecoveryMap;
+	TArray<FHasteJournalEntry> RecoveryEntries;
+	TSharedPtr<SNotificationItem> RecoveryNotification;
+
+	static FHastePlacementJournal* Instance;
+
+	friend class FHasteScopedJournalTransaction;
+};
+
+/**
+ * Attributes the records made in its scope outside of any editor transaction to a journal transaction started earlier,
+ * e.g. the instances a bulk placement streams in after the transaction that is undone to remove them was closed
+ */
+class FHasteScopedJournalTransaction
+{
+public:
+	explicit FHasteScopedJournalTransaction(int32 Transaction);
+	~FHasteScopedJournalTransaction();
+
+private:
+	int32 PreviousTransaction;
+};
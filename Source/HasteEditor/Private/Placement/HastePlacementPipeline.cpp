@@ -0,0 +1,260 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HastePlacementPipeline.h"
+#include "HasteProjectSettings.h"
+#include "ParallelFor.h"
+#include "SNotificationList.h"
+#include "NotificationManager.h"
+
+#define LOCTEXT_NAMESPACE "HastePlacementPipeline"
+
+/** Number of samples traced together. Also the unit of work handed between the stages */
+#define HASTE_PIPELINE_BATCH_SIZE 1024
+
+/** Upper limit on the batches waiting to be committed, so a large job does not hold all of its candidates in memory */
+#define HASTE_PIPELINE_MAX_BATCHES_IN_FLIGHT 16
+
+/** Number of candidates committed between checks of the frame budget */
+#define HASTE_PIPELINE_COMMIT_SLICE 64
+
+FHastePlacementPipeline::FHastePlacementPipeline()
+	: bRunning(false)
+	, NumBatches(0)
+	, NumBatchesCommitted(0)
+	, NumSamplesCommitted(0)
+	, NumPlaced(0)
+	, CommitBatch(nullptr)
+	, CommitIndex(0)
+{
+}
+
+FHastePlacementPipeline::~FHastePlacementPipeline()
+{
+	Cancel();
+}
+
+bool FHastePlacementPipeline::Start(const FHastePlacementJob& InJob)
+{
+	if (bRunning || !InJob.SampleAndTrace || !InJob.Process || !InJob.Commit) {
+		return false;
+	}
+
+	Job = InJob;
+	bRunning = true;
+	NumBatches = FMath::DivideAndRoundUp(FMath::Max(Job.NumSamples, 0), HASTE_PIPELINE_BATCH_SIZE);
+	NumBatchesCommitted = 0;
+	NumSamplesCommitted = 0;
+	NumPlaced = 0;
+	NumBatchesInFlight.Reset();
+	bCancelRequested = false;
+	bSampleStageDone = false;
+
+	SampleStage = Async<void>(EAsyncExecution::ThreadPool, [this]() { RunSampleStage(); });
+	if (Job.bProcessOnWorker) {
+		ProcessStage = Async<void>(EAsyncExecution::ThreadPool, [this]() { RunProcessStage(); });
+	}
+
+	FNotificationInfo Info(GetProgressText());
+	Info.bFireAndForget = false;
+	Info.ButtonDetails.Add(FNotificationButtonInfo(
+		LOCTEXT("CancelButton", "Cancel"),
+		LOCTEXT("CancelButtonTooltip", "Stop placing. The meshes placed so far are kept"),
+		FSimpleDelegate::CreateRaw(this, &FHastePlacementPipeline::Cancel),
+		SNotificationItem::CS_Pending));
+	Notification = FSlateNotificationManager::Get().AddNotification(Info);
+	if (Notification.IsValid()) {
+		Notification->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+	return true;
+}
+
+void FHastePlacementPipeline::Cancel()
+{
+	if (bRunning) {
+		Finish(true);
+	}
+}
+
+int32 FHastePlacementPipeline::GetBatchSeed(int32 BatchIndex) const
+{
+	return HashCombine(uint32(Job.Seed), uint32(BatchIndex));
+}
+
+void FHastePlacementPipeline::RunSampleStage()
+{
+	TArray<FHastePlacementCandidate> Samples;
+	TArray<uint8> SampleHits;
+
+	for (int32 BatchIndex = 0; BatchIndex < NumBatches && !bCancelRequested; BatchIndex++) {
+		while (NumBatchesInFlight.GetValue() >= HASTE_PIPELINE_MAX_BATCHES_IN_FLIGHT && !bCancelRequested) {
+			FPlatformProcess::Sleep(0.001f);
+		}
+
+		const int32 FirstSample = BatchIndex * HASTE_PIPELINE_BATCH_SIZE;
+		const int32 NumSamples = FMath::Min(HASTE_PIPELINE_BATCH_SIZE, Job.NumSamples - FirstSample);
+		Samples.Reset(NumSamples);
+		Samples.AddDefaulted(NumSamples);
+		SampleHits.Reset(NumSamples);
+		SampleHits.AddZeroed(NumSamples);
+
+		ParallelFor(NumSamples, [&](int32 Index) {
+			const int32 SampleIndex = FirstSample + Index;
+			FRandomStream Random(HashCombine(uint32(Job.Seed), uint32(SampleIndex)));
+			SampleHits[Index] = Job.SampleAndTrace(SampleIndex, Random, Samples[Index]) ? 1 : 0;
+			Samples[Index].SampleIndex = SampleIndex;
+		});
+
+		FHastePlacementBatch* Batch = new FHastePlacementBatch;
+		Batch->BatchIndex = BatchIndex;
+		Batch->NumSamples = NumSamples;
+		for (int32 Index = 0; Index < NumSamples; Index++) {
+			if (SampleHits[Index]) {
+				Batch->Candidates.Add(Samples[Index]);
+			}
+		}
+
+		NumBatchesInFlight.Increment();
+		TracedQueue.Enqueue(Batch);
+	}
+
+	bSampleStageDone = true;
+}
+
+void FHastePlacementPipeline::RunProcessStage()
+{
+	while (!bCancelRequested) {
+		// Read the done flag before the queue, so the last batch is not missed
+		const bool bNoMoreBatches = bSampleStageDone;
+
+		FHastePlacementBatch* Batch = nullptr;
+		if (TracedQueue.Dequeue(Batch)) {
+			Job.Process(Batch->Candidates, GetBatchSeed(Batch->BatchIndex));
+			ProcessedQueue.Enqueue(Batch);
+		}
+		else if (bNoMoreBatches) {
+			break;
+		}
+		else {
+			FPlatformProcess::Sleep(0.001f);
+		}
+	}
+}
+
+void FHastePlacementPipeline::Tick(float DeltaTime)
+{
+	if (!bRunning) {
+		return;
+	}
+
+	// The commits are not transacted themselves. Hold them back while an edit (e.g. a gizmo drag) holds a transaction
+	// open, so the placements are not recorded into it
+	if (GEditor && GEditor->IsTransactionActive()) {
+		return;
+	}
+
+	const float BudgetSeconds = GetDefault<UHasteProjectSettings>()->PlacementCommitBudget / 1000.0f;
+	const double EndTime = FPlatformTime::Seconds() + BudgetSeconds;
+	do {
+		if (!CommitBatch) {
+			FHastePlacementBatch* Batch = nullptr;
+			if (Job.bProcessOnWorker) {
+				ProcessedQueue.Dequeue(Batch);
+			}
+			else if (TracedQueue.Dequeue(Batch)) {
+				Job.Process(Batch->Candidates, GetBatchSeed(Batch->BatchIndex));
+			}
+
+			if (!Batch) {
+				break;
+			}
+			CommitBatch = Batch;
+			CommitIndex = 0;
+		}
+
+		const int32 NumToCommit = FMath::Min(HASTE_PIPELINE_COMMIT_SLICE, CommitBatch->Candidates.Num() - CommitIndex);
+		if (NumToCommit > 0) {
+			CommitSlice.Reset(NumToCommit);
+			CommitSlice.Append(CommitBatch->Candidates.GetData() + CommitIndex, NumToCommit);
+			Job.Commit(CommitSlice);
+			NumPlaced += CommitSlice.Num();
+			CommitIndex += NumToCommit;
+		}
+
+		if (CommitIndex >= CommitBatch->Candidates.Num()) {
+			NumSamplesCommitted += CommitBatch->NumSamples;
+			NumBatchesCommitted++;
+			delete CommitBatch;
+			CommitBatch = nullptr;
+			NumBatchesInFlight.Decrement();
+		}
+	} while (FPlatformTime::Seconds() < EndTime);
+
+	if (NumBatchesCommitted >= NumBatches) {
+		Finish(false);
+	}
+	else if (Notification.IsValid()) {
+		Notification->SetText(GetProgressText());
+	}
+}
+
+void FHastePlacementPipeline::Finish(bool bCancelled)
+{
+	// Stop the workers before releasing the batches they may still be working on
+	bCancelRequested = true;
+	if (SampleStage.IsValid()) {
+		SampleStage.Wait();
+	}
+	if (ProcessStage.IsValid()) {
+		ProcessStage.Wait();
+	}
+	SampleStage = TFuture<void>();
+	ProcessStage = TFuture<void>();
+
+	FHastePlacementBatch* Batch = nullptr;
+	while (TracedQueue.Dequeue(Batch)) {
+		delete Batch;
+	}
+	while (ProcessedQueue.Dequeue(Batch)) {
+		delete Batch;
+	}
+	delete CommitBatch;
+	CommitBatch = nullptr;
+	CommitSlice.Empty();
+	bRunning = false;
+
+	if (Notification.IsValid()) {
+		const FText Text = bCancelled
+			? FText::Format(LOCTEXT("JobCancelled", "{0} cancelled. Placed {1} meshes"), Job.Description, FText::AsNumber(NumPlaced))
+			: FText::Format(LOCTEXT("JobComplete", "{0} complete. Placed {1} meshes"), Job.Description, FText::AsNumber(NumPlaced));
+		Notification->SetText(Text);
+		Notification->SetCompletionState(bCancelled ? SNotificationItem::CS_Fail : SNotificationItem::CS_Success);
+		Notification->ExpireAndFadeout();
+		Notification.Reset();
+	}
+
+	// Release the captured state before notifying, the callback may start another job
+	TFunction<void(bool)> OnFinished = Job.OnFinished;
+	Job = FHastePlacementJob();
+	if (OnFinished) {
+		OnFinished(bCancelled);
+	}
+}
+
+FText FHastePlacementPipeline::GetProgressText() const
+{
+	const float Progress = Job.NumSamples > 0 ? float(NumSamplesCommitted) / Job.NumSamples : 1.0f;
+	return FText::Format(LOCTEXT("JobProgress", "{0}: placed {1} meshes ({2})"),
+		Job.Description, FText::AsNumber(NumPlaced), FText::AsPercent(Progress));
+}
+
+TStatId FHastePlacementPipeline::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FHastePlacementPipeline, STATGROUP_Tickables);
+}
+
+void FHastePlacementPipeline::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(Job.ReferencedObjects);
+}
+
+#undef LOCTEXT_NAMESPACE
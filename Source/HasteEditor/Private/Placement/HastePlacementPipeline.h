@@ -0,0 +1,118 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "HastePlacement.h"
+#include "TickableEditorObject.h"
+#include "Queue.h"
+#include "Async.h"
+
+class SNotificationItem;
+
+/** A run of consecutive samples flowing through the placement pipeline */
+struct FHastePlacementBatch
+{
+	int32 BatchIndex;
+	int32 NumSamples;
+
+	/** The samples that hit a surface. After the process stage, the transforms include the transformers */
+	TArray<FHastePlacementCandidate> Candidates;
+};
+
+/** Describes a bulk placement operation and the work done by each stage of the pipeline */
+struct FHastePlacementJob
+{
+	FHastePlacementJob()
+		: NumSamples(0)
+		, Seed(0)
+		, bProcessOnWorker(false)
+	{
+	}
+
+	/** Shown in the progress notification */
+	FText Description;
+
+	int32 NumSamples;
+	int32 Seed;
+
+	/**
+	 * Worker threads: generates the sample and projects it on to the surface. Returns false if the sample missed.
+	 * Called concurrently, the random stream is seeded from the sample index so the result does not depend on the thread count
+	 */
+	TFunction<bool(int32 SampleIndex, FRandomStream& Random, FHastePlacementCandidate& OutCandidate)> SampleAndTrace;
+
+	/** Filters and transforms a batch. Runs on a worker thread if bProcessOnWorker is set, otherwise on the game thread */
+	TFunction<void(TArray<FHastePlacementCandidate>& Candidates, int32 Seed)> Process;
+	bool bProcessOnWorker;
+
+	/** Game thread: adds a slice of processed candidates to the level. Never called while a transaction is open */
+	TFunction<void(TArray<FHastePlacementCandidate>& Candidates)> Commit;
+
+	/** Game thread: called once the job completes or is cancelled */
+	TFunction<void(bool bCancelled)> OnFinished;
+
+	/** Objects used by the stages, kept alive while the job runs */
+	TArray<UObject*> ReferencedObjects;
+};
+
+/**
+ * Streams a bulk placement into the level without freezing the editor.
+ * Samples are traced on worker threads and filtered and transformed on a worker (or the game thread if any rule
+ * is not thread safe). The stages are connected with lock-free queues, and the game thread commits the results
+ * within a per-frame time budget while a notification shows the progress and offers to cancel
+ */
+class FHastePlacementPipeline : public FTickableEditorObject, public FGCObject
+{
+public:
+	FHastePlacementPipeline();
+	virtual ~FHastePlacementPipeline();
+
+	/** Starts the job. Returns false if another job is still running */
+	bool Start(const FHastePlacementJob& InJob);
+
+	/** Stops the job. The placements committed so far are kept */
+	void Cancel();
+
+	bool IsRunning() const { return bRunning; }
+
+	/** FTickableEditorObject interface */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return bRunning; }
+	virtual TStatId GetStatId() const override;
+
+	/** FGCObject interface */
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+private:
+	void RunSampleStage();
+	void RunProcessStage();
+	void Finish(bool bCancelled);
+
+	int32 GetBatchSeed(int32 BatchIndex) const;
+	FText GetProgressText() const;
+
+private:
+	FHastePlacementJob Job;
+	bool bRunning;
+	int32 NumBatches;
+	int32 NumBatchesCommitted;
+	int32 NumSamplesCommitted;
+	int32 NumPlaced;
+
+	/** Stage connections. Each queue has a single producer and a single consumer */
+	TQueue<FHastePlacementBatch*, EQueueMode::Spsc> TracedQueue;
+	TQueue<FHastePlacementBatch*, EQueueMode::Spsc> ProcessedQueue;
+
+	/** Batches that were sampled but not committed yet, used to hold the sample stage back */
+	FThreadSafeCounter NumBatchesInFlight;
+	FThreadSafeBool bCancelRequested;
+	FThreadSafeBool bSampleStageDone;
+
+	TFuture<void> SampleStage;
+	TFuture<void> ProcessStage;
+
+	/** The batch being committed by the game thread, and the index of its next candidate */
+	FHastePlacementBatch* CommitBatch;
+	int32 CommitIndex;
+	TArray<FHastePlacementCandidate> CommitSlice;
+
+	TSharedPtr<SNotificationItem> Notification;
+};
@@ -0,0 +1,271 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteScatterRecord.h"
+#include "HasteEdModeSettings.h"
+#include "HasteInstanceContainer.h"
+#include "HastePlacementJournal.h"
+#include "Sampling/HasteBlueNoise.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
+/** Largest difference between a recorded transform and the instance it was added as, after the round trip through the component */
+#define HASTE_SCATTER_MATCH_TOLERANCE 0.1f
+#define HASTE_SCATTER_MATCH_ROTATION_TOLERANCE 1.e-3f
+#define HASTE_SCATTER_MATCH_SCALE_TOLERANCE 1.e-3f
+
+/** Revisions of the records kept for undo. Undoing past the oldest one drops the records, so the cells are no longer regenerated */
+#define HASTE_SCATTER_UNDO_HISTORY 16
+
+FHasteScatterRecords::FHasteScatterRecords()
+	: UndoMarker(nullptr)
+	, Revision(0)
+	, NextRevision(1)
+{
+}
+
+void FHasteScatterRecords::Reset()
+{
+	Regions.Reset();
+	History.Reset();
+	if (UndoMarker) {
+		Revision = UndoMarker->Revision;
+	}
+}
+
+void FHasteScatterRecords::Modify()
+{
+	if (!UndoMarker) {
+		UndoMarker = NewObject<UHasteScatterUndoMarker>(GetTransientPackage(), NAME_None, RF_Transactional);
+		UndoMarker->Revision = Revision;
+	}
+
+	// The revisions after the current one were undone, and the new transaction discards their redo
+	for (auto It = History.CreateIterator(); It; ++It) {
+		if (It.Key() > Revision) {
+			It.RemoveCurrent();
+		}
+	}
+	History.Add(Revision, Regions);
+	while (History.Num() > HASTE_SCATTER_UNDO_HISTORY) {
+		int32 OldestRevision = MAX_int32;
+		for (const auto& Entry : History) {
+			OldestRevision = FMath::Min(OldestRevision, Entry.Key);
+		}
+		History.Remove(OldestRevision);
+	}
+
+	// The marker is saved into the editor transaction before it changes, so undoing it restores the previous revision
+	UndoMarker->Modify(false);
+	UndoMarker->Revision = NextRevision++;
+	Revision = UndoMarker->Revision;
+}
+
+bool FHasteScatterRecords::IsStale() const
+{
+	return UndoMarker && UndoMarker->Revision != Revision;
+}
+
+void FHasteScatterRecords::Restore()
+{
+	if (!IsStale()) {
+		return;
+	}
+
+	// Keep the records in use, so a redo gets back what the undo took away
+	History.Add(Revision, MoveTemp(Regions));
+	Regions.Reset();
+	if (const TArray<FHasteScatterRegion>* Snapshot = History.Find(UndoMarker->Revision)) {
+		Regions = *Snapshot;
+	}
+	Revision = UndoMarker->Revision;
+}
+
+void FHasteScatterRecords::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(UndoMarker);
+	for (FHasteScatterRegion& Region : Regions) {
+		Collector.AddReferencedObjects(Region.Meshes);
+	}
+	for (auto& Entry : History) {
+		for (FHasteScatterRegion& Region : Entry.Value) {
+			Collector.AddReferencedObjects(Region.Meshes);
+		}
+	}
+}
+
+int32 FHasteScatterRecords::AddRegion(ULevel* Level, const FBox& Bounds, float CellSize, int32 Seed)
+{
+	FHasteScatterRegion Region;
+	Region.Level = Level;
+	Region.CellSize = CellSize;
+	Region.Seed = Seed;
+
+	const int32 MinX = FMath::FloorToInt(Bounds.Min.X / CellSize);
+	const int32 MinY = FMath::FloorToInt(Bounds.Min.Y / CellSize);
+	const int32 MaxX = FMath::CeilToInt(Bounds.Max.X / CellSize) - 1;
+	const int32 MaxY = FMath::CeilToInt(Bounds.Max.Y / CellSize) - 1;
+	for (int32 Y = MinY; Y <= MaxY; Y++) {
+		for (int32 X = MinX; X <= MaxX; X++) {
+			FHasteScatterCell Cell;
+			Cell.Coord = FIntPoint(X, Y);
+			Cell.Bounds = FBox(FVector(X * CellSize, Y * CellSize, Bounds.Min.Z), FVector((X + 1) * CellSize, (Y + 1) * CellSize, Bounds.Max.Z));
+			Cell.Seed = HashCombine(HashCombine(uint32(Seed), uint32(X)), uint32(Y));
+			Cell.RuleHash = 0;
+			Cell.SurfaceHash = 0;
+			Region.Cells.Add(Cell);
+		}
+	}
+	return Regions.Add(Region);
+}
+
+static uint32 HashEditableProperties(const UObject* Object, uint32 Hash)
+{
+	if (!Object) {
+		return HashCombine(Hash, 0);
+	}
+
+	Hash = HashCombine(Hash, GetTypeHash(Object->GetClass()->GetFName()));
+	for (TFieldIterator<UProperty> It(Object->GetClass()); It; ++It) {
+		if (!It->HasAnyPropertyFlags(CPF_Edit)) continue;
+
+		FString Value;
+		It->ExportTextItem(Value, It->ContainerPtrToValuePtr<uint8>(Object), nullptr, nullptr, PPF_None);
+		Hash = FCrc::StrCrc32(*Value, Hash);
+	}
+	return Hash;
+}
+
+uint32 FHasteScatterRecords::HashRules(const UHasteEdModeSettings* Settings, const TArray<UStaticMesh*>& Meshes)
+{
+	uint32 Hash = 0;
+	for (UStaticMesh* Mesh : Meshes) {
+		Hash = HashCombine(Hash, GetTypeHash(Mesh));
+	}
+
+	Hash = HashCombine(Hash, GetTypeHash(Settings->PaintDensity));
+	Hash = HashCombine(Hash, GetTypeHash(uint8(Settings->SampleMode)));
+	Hash = HashCombine(Hash, GetTypeHash(Settings->BlueNoiseTiles));
+	if (Settings->BlueNoiseTiles) {
+		Hash = HashCombine(Hash, GetTypeHash(Settings->BlueNoiseTiles->GenerationSeed));
+		Hash = HashCombine(Hash, GetTypeHash(Settings->BlueNoiseTiles->PointsPerTile));
+		Hash = HashCombine(Hash, GetTypeHash(Settings->BlueNoiseTiles->NumVariations));
+	}
+	Hash = HashCombine(Hash, GetTypeHash(uint8(Settings->bRejectOverlaps)));
+	Hash = HashCombine(Hash, GetTypeHash(uint8(Settings->OverlapShape)));
+	Hash = HashCombine(Hash, GetTypeHash(Settings->OverlapBoundsScale));
+
+	// The landscape layer mask is only used without a texture, and covers the whole landscape
+	Hash = HashCombine(Hash, GetTypeHash(Settings->DensityMaskTexture ? nullptr : Settings->DensityMaskLayer));
+	for (const UHasteTransformLogic* TransformLogic : Settings->Transformers) {
+		Hash = HashEditableProperties(TransformLogic, Hash);
+	}
+	return Hash;
+}
+
+uint32 FHasteScatterRecords::HashCellRules(const UHasteEdModeSettings* Settings, const FHasteScatterCell& Cell, uint32 RegionRuleHash)
+{
+	uint32 Hash = RegionRuleHash;
+
+	// Outside of its rectangle a texture mask leaves the density unchanged, so editing it only affects the cells it covers
+	if (UTexture2D* Texture = Settings->DensityMaskTexture) {
+		const FBox2D MaskBounds(Settings->DensityMaskOrigin, Settings->DensityMaskOrigin + Settings->DensityMaskSize);
+		if (MaskBounds.Intersect(FBox2D(FVector2D(Cell.Bounds.Min), FVector2D(Cell.Bounds.Max)))) {
+			Hash = HashCombine(Hash, GetTypeHash(Texture));
+			Hash = HashCombine(Hash, GetTypeHash(Texture->Source.GetId()));
+			Hash = HashCombine(Hash, GetTypeHash(uint8(Settings->DensityMaskChannel)));
+			Hash = HashCombine(Hash, GetTypeHash(Settings->DensityMaskOrigin));
+			Hash = HashCombine(Hash, GetTypeHash(Settings->DensityMaskSize));
+		}
+	}
+
+	// Blueprint filters can read anything from the hit, so all of their properties count
+	for (const UHastePlacementFilter* Filter : Settings->Filters) {
+		uint32 FilterHash = 0;
+		if (Filter && Filter->GetClass()->HasAnyClassFlags(CLASS_Native) && Filter->HashForSurface(Cell.SurfaceStats, FilterHash)) {
+			Hash = HashCombine(HashCombine(Hash, GetTypeHash(Filter->GetClass()->GetFName())), FilterHash);
+		}
+		else {
+			Hash = HashEditableProperties(Filter, Hash);
+		}
+	}
+	return Hash;
+}
+
+static FIntVector GetMatchBucket(const FVector& Location)
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / HASTE_SCATTER_MATCH_TOLERANCE),
+		FMath::FloorToInt(Location.Y / HASTE_SCATTER_MATCH_TOLERANCE),
+		FMath::FloorToInt(Location.Z / HASTE_SCATTER_MATCH_TOLERANCE));
+}
+
+static bool IsSameInstance(const FTransform& Recorded, const FTransform& Instance)
+{
+	return Recorded.GetLocation().Equals(Instance.GetLocation(), HASTE_SCATTER_MATCH_TOLERANCE)
+		&& Recorded.GetRotation().Equals(Instance.GetRotation(), HASTE_SCATTER_MATCH_ROTATION_TOLERANCE)
+		&& Recorded.GetScale3D().Equals(Instance.GetScale3D(), HASTE_SCATTER_MATCH_SCALE_TOLERANCE);
+}
+
+int32 FHasteScatterRecords::RemovePlacements(const TArray<FHasteScatterCell*>& Cells)
+{
+	// Instance indices shift as instances are removed, so the records are matched by transform instead.
+	// The records are bucketed by location, and an instance searches the buckets around its own, so a location
+	// that moved across a bucket edge in the round trip through the component is still found
+	struct FComponentRecords
+	{
+		TArray<FTransform> Transforms;
+		TArray<bool> Matched;
+		TMultiMap<FIntVector, int32> Buckets;
+	};
+	TMap<UHierarchicalInstancedStaticMeshComponent*, FComponentRecords> RecordsByComponent;
+	for (FHasteScatterCell* Cell : Cells) {
+		for (const FHasteScatterPlacement& Placement : Cell->Placements) {
+			UHierarchicalInstancedStaticMeshComponent* Component = Placement.Component.Get();
+			if (!Component || !Component->ComponentHasTag(FHasteTags::ScatterComponent)) continue;
+
+			FComponentRecords& Records = RecordsByComponent.FindOrAdd(Component);
+			const int32 RecordIndex = Records.Transforms.Add(Placement.Transform);
+			Records.Matched.Add(false);
+			Records.Buckets.Add(GetMatchBucket(Placement.Transform.GetLocation()), RecordIndex);
+		}
+		Cell->Placements.Reset();
+	}
+
+	int32 NumRemoved = 0;
+	FHastePlacementJournal* Journal = FHastePlacementJournal::Get();
+	for (auto& Entry : RecordsByComponent) {
+		UHierarchicalInstancedStaticMeshComponent* Component = Entry.Key;
+		FComponentRecords& Records = Entry.Value;
+		TArray<int32> InstancesToRemove;
+		for (int32 InstanceIndex = 0; InstanceIndex < Component->GetInstanceCount(); InstanceIndex++) {
+			FTransform InstanceTransform;
+			if (!Component->GetInstanceTransform(InstanceIndex, InstanceTransform, true)) continue;
+
+			// Every record is used up by the first instance it matches
+			const FIntVector Bucket = GetMatchBucket(InstanceTransform.GetLocation());
+			bool bMatched = false;
+			for (int32 Z = -1; Z <= 1 && !bMatched; Z++) {
+				for (int32 Y = -1; Y <= 1 && !bMatched; Y++) {
+					for (int32 X = -1; X <= 1 && !bMatched; X++) {
+						for (auto It = Records.Buckets.CreateConstKeyIterator(Bucket + FIntVector(X, Y, Z)); It; ++It) {
+							const int32 RecordIndex = It.Value();
+							if (!Records.Matched[RecordIndex] && IsSameInstance(Records.Transforms[RecordIndex], InstanceTransform)) {
+								Records.Matched[RecordIndex] = true;
+								bMatched = true;
+								break;
+							}
+						}
+					}
+				}
+			}
+
+			if (bMatched) {
+				InstancesToRemove.Add(InstanceIndex);
+				if (Journal) {
+					Journal->RecordErase(Component->GetStaticMesh(), InstanceTransform, Component->GetComponentLevel(), true);
+				}
+			}
+		}
+		NumRemoved += FHasteInstanceContainers::RemoveInstances(Component, InstancesToRemove);
+	}
+	return NumRemoved;
+}
@@ -0,0 +1,115 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "HastePlacement.h"
+#include "HasteScatterRecord.generated.h"
+
+class UHasteEdModeSettings;
+class UHierarchicalInstancedStaticMeshComponent;
+
+/**
+ * Transactional value that follows the undo history. Every change to the scatter records saves it into the editor
+ * transaction before bumping it, so after an undo or redo it holds the revision of the records that is current again
+ */
+UCLASS()
+class UHasteScatterUndoMarker : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	int32 Revision;
+};
+
+/** An instance committed by a scatter operation */
+struct FHasteScatterPlacement
+{
+	TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent> Component;
+	FTransform Transform;
+};
+
+/** One grid cell of a scatter region and the inputs it was generated from */
+struct FHasteScatterCell
+{
+	FIntPoint Coord;
+	FBox Bounds;
+	int32 Seed;
+
+	/** Hash of the placement rules the cell was generated with, narrowed down to the ones that affect the cell */
+	uint32 RuleHash;
+
+	/** The surface the cell was generated on, as seen by the filters */
+	FHasteSurfaceStats SurfaceStats;
+
+	/** Coarse signature of the surface under the cell, ignoring the Haste instances */
+	uint32 SurfaceHash;
+
+	TArray<FHasteScatterPlacement> Placements;
+};
+
+/** An area filled in one operation, split into cells that are regenerated independently */
+struct FHasteScatterRegion
+{
+	TWeakObjectPtr<ULevel> Level;
+	float CellSize;
+
+	/** Seeds the cells, and the blue noise tiles that cover the region */
+	int32 Seed;
+
+	/** The palette the region was filled with */
+	TArray<UStaticMesh*> Meshes;
+	TArray<FHasteScatterCell> Cells;
+};
+
+/**
+ * Remembers the seed and rule version of every scattered cell, so a change to the rules or the surface
+ * only regenerates the cells that are affected. The records follow the undo history, but are not saved
+ * with the level: they live for the editor session
+ */
+class FHasteScatterRecords
+{
+public:
+	FHasteScatterRecords();
+
+	void Reset();
+
+	/** Snapshots the records before they change. Must be called inside the transaction of the change */
+	void Modify();
+
+	/** True if an undo or redo moved to another revision of the records than the one in use */
+	bool IsStale() const;
+
+	/** Switches to the records of the revision that is current after an undo or redo */
+	void Restore();
+
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+	/** Creates a region covering the bounds with cells aligned to the world grid. Returns its index */
+	int32 AddRegion(ULevel* Level, const FBox& Bounds, float CellSize, int32 Seed);
+
+	TArray<FHasteScatterRegion>& GetRegions() { return Regions; }
+
+	/** Hash of the rules that affect every cell of a region alike */
+	static uint32 HashRules(const UHasteEdModeSettings* Settings, const TArray<UStaticMesh*>& Meshes);
+
+	/**
+	 * Hash of the rules that only affect some cells: the density mask if it covers the cell, and the filters
+	 * narrowed down to the surface the cell was generated on. Combined with the region hash
+	 */
+	static uint32 HashCellRules(const UHasteEdModeSettings* Settings, const FHasteScatterCell& Cell, uint32 RegionRuleHash);
+
+	/**
+	 * Removes the recorded instances of the cells from their scatter components in one pass per component.
+	 * Every record removes at most one instance. Returns the number of instances removed
+	 */
+	static int32 RemovePlacements(const TArray<FHasteScatterCell*>& Cells);
+
+private:
+	TArray<FHasteScatterRegion> Regions;
+
+	/** The records of the revisions that can be restored by an undo or redo */
+	TMap<int32, TArray<FHasteScatterRegion>> History;
+
+	UHasteScatterUndoMarker* UndoMarker;
+	int32 Revision;
+	int32 NextRevision;
+};
@@ -0,0 +1,133 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteSpatialIndex.h"
+
+#define HASTE_MAX_CELLS_PER_ENTRY 64
+
+FHasteSpatialIndex::FHasteSpatialIndex(float InCellSize)
+	: CellSize(InCellSize)
+	, QueryMarker(0)
+{
+}
+
+void FHasteSpatialIndex::Reset()
+{
+	Entries.Reset();
+	Cells.Reset();
+	LargeEntries.Reset();
+	FreeEntries.Reset();
+	QueryMarkers.Reset();
+	QueryMarker = 0;
+}
+
+FIntVector FHasteSpatialIndex::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+bool FHasteSpatialIndex::IsLargeEntry(const FIntVector& Min, const FIntVector& Max) const
+{
+	const int64 NumCells = int64(Max.X - Min.X + 1) * (Max.Y - Min.Y + 1) * (Max.Z - Min.Z + 1);
+	return NumCells > HASTE_MAX_CELLS_PER_ENTRY;
+}
+
+int32 FHasteSpatialIndex::Add(const FHasteSpatialEntry& Entry)
+{
+	int32 Index;
+	if (FreeEntries.Num() > 0) {
+		Index = FreeEntries.Pop(false);
+		Entries[Index] = Entry;
+	}
+	else {
+		Index = Entries.Add(Entry);
+		QueryMarkers.Add(0);
+	}
+
+	const FIntVector Min = GetCell(Entry.BoundingBox.Min);
+	const FIntVector Max = GetCell(Entry.BoundingBox.Max);
+	if (IsLargeEntry(Min, Max)) {
+		LargeEntries.Add(Index);
+		return Index;
+	}
+
+	for (int32 X = Min.X; X <= Max.X; X++) {
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++) {
+			for (int32 Z = Min.Z; Z <= Max.Z; Z++) {
+				Cells.FindOrAdd(FIntVector(X, Y, Z)).Add(Index);
+			}
+		}
+	}
+	return Index;
+}
+
+void FHasteSpatialIndex::Remove(int32 Index)
+{
+	if (!Entries.IsValidIndex(Index)) {
+		return;
+	}
+
+	// The cells the entry was hashed into are found again from its bounding box
+	const FHasteSpatialEntry& Entry = Entries[Index];
+	const FIntVector Min = GetCell(Entry.BoundingBox.Min);
+	const FIntVector Max = GetCell(Entry.BoundingBox.Max);
+	if (IsLargeEntry(Min, Max)) {
+		LargeEntries.RemoveSingleSwap(Index, false);
+	}
+	else {
+		for (int32 X = Min.X; X <= Max.X; X++) {
+			for (int32 Y = Min.Y; Y <= Max.Y; Y++) {
+				for (int32 Z = Min.Z; Z <= Max.Z; Z++) {
+					const FIntVector Cell(X, Y, Z);
+					if (TArray<int32>* CellEntries = Cells.Find(Cell)) {
+						CellEntries->RemoveSingleSwap(Index, false);
+						if (CellEntries->Num() == 0) {
+							Cells.Remove(Cell);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	Entries[Index] = FHasteSpatialEntry();
+	FreeEntries.Add(Index);
+}
+
+void FHasteSpatialIndex::Query(const FBox& Box, TArray<int32>& OutEntries) const
+{
+	// Bump the marker so entries visited in earlier queries are considered again
+	QueryMarker++;
+	if (QueryMarker == 0) {
+		FMemory::Memzero(QueryMarkers.GetData(), QueryMarkers.Num() * sizeof(uint32));
+		QueryMarker = 1;
+	}
+
+	auto VisitEntry = [&](int32 Index) {
+		if (QueryMarkers[Index] == QueryMarker) return;
+		QueryMarkers[Index] = QueryMarker;
+		if (Entries[Index].BoundingBox.Intersect(Box)) {
+			OutEntries.Add(Index);
+		}
+	};
+
+	const FIntVector Min = GetCell(Box.Min);
+	const FIntVector Max = GetCell(Box.Max);
+	for (int32 X = Min.X; X <= Max.X; X++) {
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++) {
+			for (int32 Z = Min.Z; Z <= Max.Z; Z++) {
+				if (const TArray<int32>* CellEntries = Cells.Find(FIntVector(X, Y, Z))) {
+					for (int32 Index : *CellEntries) {
+						VisitEntry(Index);
+					}
+				}
+			}
+		}
+	}
+
+	for (int32 Index : LargeEntries) {
+		VisitEntry(Index);
+	}
+}
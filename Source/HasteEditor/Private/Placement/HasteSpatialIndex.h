@@ -0,0 +1,67 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "HasteMeshBounds.h"
+
+/** A placement registered in the spatial index */
+struct FHasteSpatialEntry
+{
+	FHasteSpatialEntry()
+		: Mesh(nullptr)
+		, InstanceIndex(INDEX_NONE)
+	{
+	}
+
+	UStaticMesh* Mesh;
+	FTransform Transform;
+	FHastePlacedBounds Bounds;
+	FBox BoundingBox;
+
+	/** The component that renders this placement. May be null while the placement is still being committed */
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+
+	/** Instance index within the component, for instanced components */
+	int32 InstanceIndex;
+};
+
+/**
+ * Uniform grid hash over placed meshes, used for fast neighbour queries
+ * without going through the physics scene
+ */
+class FHasteSpatialIndex
+{
+public:
+	explicit FHasteSpatialIndex(float InCellSize = 1000.0f);
+
+	void Reset();
+
+	/** Registers an entry and returns its index. The slots of removed entries are reused */
+	int32 Add(const FHasteSpatialEntry& Entry);
+
+	/** Unregisters an entry. Its index stays free until the next Add */
+	void Remove(int32 Index);
+
+	/** Finds all entries whose bounding box intersects the query box */
+	void Query(const FBox& Box, TArray<int32>& OutEntries) const;
+
+	const FHasteSpatialEntry& GetEntry(int32 Index) const { return Entries[Index]; }
+	int32 Num() const { return Entries.Num(); }
+
+private:
+	FIntVector GetCell(const FVector& Location) const;
+	bool IsLargeEntry(const FIntVector& Min, const FIntVector& Max) const;
+
+private:
+	float CellSize;
+	TArray<FHasteSpatialEntry> Entries;
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	/** Entries that span too many cells to be hashed are tested on every query */
+	TArray<int32> LargeEntries;
+
+	/** Slots of removed entries */
+	TArray<int32> FreeEntries;
+
+	/** Used to avoid reporting the same entry twice when it spans multiple cells */
+	mutable TArray<uint32> QueryMarkers;
+	mutable uint32 QueryMarker;
+};
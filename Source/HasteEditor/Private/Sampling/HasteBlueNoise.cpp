@@ -0,0 +1,175 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteBlueNoise.h"
+
+/** Random candidates tried for every generated point. More candidates give a more even spacing */
+#define HASTE_BLUE_NOISE_CANDIDATES 16
+
+/** Upper limit on the tiles visited by a single lookup, so a tiny density cannot stall the editor */
+#define HASTE_BLUE_NOISE_MAX_TILES (256 * 256)
+
+/** Points of neighbouring tiles closer than this, as a fraction of the mean point spacing, are thinned out */
+#define HASTE_BLUE_NOISE_SEAM_SPACING 0.5f
+
+UHasteBlueNoiseTiles::UHasteBlueNoiseTiles(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, PointsPerTile(256)
+	, NumVariations(4)
+	, GenerationSeed(0)
+{
+}
+
+void UHasteBlueNoiseTiles::Generate()
+{
+	PointsPerTile = FMath::Clamp(PointsPerTile, 16, 1024);
+	NumVariations = FMath::Clamp(NumVariations, 1, 8);
+
+	// Best candidate sampling: of a few random candidates, keep the one furthest away from the points of the tile so far.
+	// Distances wrap around the tile, so the tile is seamless with itself
+	FRandomStream Random(GenerationSeed);
+	Points.Reset(PointsPerTile * NumVariations);
+	for (int32 Variation = 0; Variation < NumVariations; Variation++) {
+		const int32 FirstPoint = Points.Num();
+		for (int32 PointIndex = 0; PointIndex < PointsPerTile; PointIndex++) {
+			FVector2D BestPoint(Random.FRand(), Random.FRand());
+			float BestDistanceSq = -1;
+			for (int32 Candidate = 0; Candidate < HASTE_BLUE_NOISE_CANDIDATES && PointIndex > 0; Candidate++) {
+				const FVector2D Point = Candidate == 0 ? BestPoint : FVector2D(Random.FRand(), Random.FRand());
+				float NearestSq = MAX_flt;
+				for (int32 Other = FirstPoint; Other < Points.Num(); Other++) {
+					float DX = FMath::Abs(Point.X - Points[Other].X);
+					float DY = FMath::Abs(Point.Y - Points[Other].Y);
+					DX = FMath::Min(DX, 1 - DX);
+					DY = FMath::Min(DY, 1 - DY);
+					NearestSq = FMath::Min(NearestSq, DX * DX + DY * DY);
+				}
+				if (NearestSq > BestDistanceSq) {
+					BestDistanceSq = NearestSq;
+					BestPoint = Point;
+				}
+			}
+			Points.Add(BestPoint);
+		}
+	}
+}
+
+float UHasteBlueNoiseTiles::GetTileSize(float Density) const
+{
+	return 1000.0f * FMath::Sqrt(PointsPerTile / FMath::Max(Density, KINDA_SMALL_NUMBER));
+}
+
+void UHasteBlueNoiseTiles::GetTilePoints(int32 TileX, int32 TileY, float TileSize, int32 Seed, TArray<FVector2D>& OutPoints) const
+{
+	const int32 NumTileVariations = Points.Num() / PointsPerTile;
+	FRandomStream TileRandom(HashCombine(HashCombine(uint32(Seed), uint32(TileX)), uint32(TileY)));
+	const int32 Variation = TileRandom.RandRange(0, NumTileVariations - 1);
+	const int32 QuarterTurns = TileRandom.RandRange(0, 3);
+	const FVector2D Offset(TileRandom.FRand(), TileRandom.FRand());
+	const FVector2D TileOrigin(TileX * TileSize, TileY * TileSize);
+
+	OutPoints.Reset(PointsPerTile);
+	const FVector2D* TilePoints = Points.GetData() + Variation * PointsPerTile;
+	for (int32 PointIndex = 0; PointIndex < PointsPerTile; PointIndex++) {
+		const float U = FMath::Frac(TilePoints[PointIndex].X + Offset.X);
+		const float V = FMath::Frac(TilePoints[PointIndex].Y + Offset.Y);
+
+		// Quarter turns map the unit square on to itself, so the rotated tile stays seamless
+		FVector2D Local;
+		switch (QuarterTurns)
+		{
+		case 1:		Local = FVector2D(1 - V, U); break;
+		case 2:		Local = FVector2D(1 - U, 1 - V); break;
+		case 3:		Local = FVector2D(V, 1 - U); break;
+		default:	Local = FVector2D(U, V); break;
+		}
+		OutPoints.Add(TileOrigin + Local * TileSize);
+	}
+}
+
+/** Decides which of two neighbouring tiles keeps its points where they crowd each other. Depends only on the seed and the tiles */
+static bool OutranksTile(int32 Seed, const FIntPoint& Tile, const FIntPoint& Other)
+{
+	const uint32 Rank = HashCombine(HashCombine(uint32(Seed), uint32(Tile.X)), uint32(Tile.Y));
+	const uint32 OtherRank = HashCombine(HashCombine(uint32(Seed), uint32(Other.X)), uint32(Other.Y));
+	if (Rank != OtherRank) {
+		return Rank > OtherRank;
+	}
+	return Tile.Y != Other.Y ? Tile.Y > Other.Y : Tile.X > Other.X;
+}
+
+void UHasteBlueNoiseTiles::GetPoints(const FBox2D& Area, float TileSize, int32 Seed, TArray<FVector2D>& OutPoints) const
+{
+	const int32 NumTileVariations = PointsPerTile > 0 ? Points.Num() / PointsPerTile : 0;
+	if (NumTileVariations == 0 || TileSize <= 0) {
+		return;
+	}
+
+	const int32 MinX = FMath::FloorToInt(Area.Min.X / TileSize);
+	const int32 MinY = FMath::FloorToInt(Area.Min.Y / TileSize);
+	const int32 MaxX = FMath::FloorToInt(Area.Max.X / TileSize);
+	const int32 MaxY = FMath::FloorToInt(Area.Max.Y / TileSize);
+	if (int64(MaxX - MinX + 3) * (MaxY - MinY + 3) > HASTE_BLUE_NOISE_MAX_TILES) {
+		return;
+	}
+
+	// Only points this close to the edge of their tile can crowd a point of the neighbouring tile. They are collected
+	// for the tiles around the area as well, so a point is kept or dropped the same way whatever area it is looked up with
+	const float SeamDistance = HASTE_BLUE_NOISE_SEAM_SPACING * TileSize / FMath::Sqrt(float(PointsPerTile));
+	const int32 RingSizeX = MaxX - MinX + 3;
+	TArray<TArray<FVector2D>> BorderPoints;
+	BorderPoints.SetNum(RingSizeX * (MaxY - MinY + 3));
+	TArray<FVector2D> TilePoints;
+	for (int32 TileY = MinY - 1; TileY <= MaxY + 1; TileY++) {
+		for (int32 TileX = MinX - 1; TileX <= MaxX + 1; TileX++) {
+			const FBox2D InnerBounds(FVector2D(TileX * TileSize + SeamDistance, TileY * TileSize + SeamDistance), FVector2D((TileX + 1) * TileSize - SeamDistance, (TileY + 1) * TileSize - SeamDistance));
+			GetTilePoints(TileX, TileY, TileSize, Seed, TilePoints);
+			for (const FVector2D& Point : TilePoints) {
+				if (!InnerBounds.IsInside(Point)) {
+					BorderPoints[(TileY - MinY + 1) * RingSizeX + (TileX - MinX + 1)].Add(Point);
+				}
+			}
+		}
+	}
+
+	const float SeamDistanceSq = FMath::Square(SeamDistance);
+	for (int32 TileY = MinY; TileY <= MaxY; TileY++) {
+		for (int32 TileX = MinX; TileX <= MaxX; TileX++) {
+			const FIntPoint Tile(TileX, TileY);
+			const FBox2D InnerBounds(FVector2D(TileX * TileSize + SeamDistance, TileY * TileSize + SeamDistance), FVector2D((TileX + 1) * TileSize - SeamDistance, (TileY + 1) * TileSize - SeamDistance));
+			GetTilePoints(TileX, TileY, TileSize, Seed, TilePoints);
+			for (const FVector2D& Point : TilePoints) {
+				if (!Area.IsInside(Point)) continue;
+
+				bool bCrowded = false;
+				if (!InnerBounds.IsInside(Point)) {
+					for (int32 Y = -1; Y <= 1 && !bCrowded; Y++) {
+						for (int32 X = -1; X <= 1 && !bCrowded; X++) {
+							const FIntPoint Other(TileX + X, TileY + Y);
+							if (Other == Tile || !OutranksTile(Seed, Other, Tile)) continue;
+
+							for (const FVector2D& OtherPoint : BorderPoints[(Other.Y - MinY + 1) * RingSizeX + (Other.X - MinX + 1)]) {
+								if (FVector2D::DistSquared(Point, OtherPoint) < SeamDistanceSq) {
+									bCrowded = true;
+									break;
+								}
+							}
+						}
+					}
+				}
+				if (!bCrowded) {
+					OutPoints.Add(Point);
+				}
+			}
+		}
+	}
+}
+
+void UHasteBlueNoiseTiles::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Generating is quadratic in the points per tile, so wait until a slider is released
+	if (PropertyChangedEvent.ChangeType != EPropertyChangeType::Interactive) {
+		Generate();
+	}
+}
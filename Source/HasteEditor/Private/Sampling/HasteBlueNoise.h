@@ -0,0 +1,46 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "HasteBlueNoise.generated.h"
+
+/**
+ * Precomputed, tileable blue noise point sets. Every tile is generated on a torus, so its points keep their
+ * spacing across the tile borders. Sampling an area is a lookup over the tiles that cover it, where each tile
+ * picks a variation, a quarter turn and a wrapped offset from the seed to hide the repetition. Neighbouring tiles
+ * no longer line up after that, so of two points that crowd each other across a border, the one of the lower
+ * ranked tile is dropped
+ */
+UCLASS(BlueprintType)
+class UHasteBlueNoiseTiles : public UObject {
+	GENERATED_UCLASS_BODY()
+
+public:
+	/** Number of points in every tile. The tiles are sized so the points match the paint density */
+	UPROPERTY(EditAnywhere, Category = BlueNoise, meta = (ClampMin = "16", ClampMax = "1024"))
+	int32 PointsPerTile;
+
+	/** Number of different tiles to choose from */
+	UPROPERTY(EditAnywhere, Category = BlueNoise, meta = (ClampMin = "1", ClampMax = "8"))
+	int32 NumVariations;
+
+	UPROPERTY(EditAnywhere, Category = BlueNoise)
+	int32 GenerationSeed;
+
+	/** The points of every variation, in the unit square */
+	UPROPERTY()
+	TArray<FVector2D> Points;
+
+	/** Regenerates the point sets from the generation settings */
+	void Generate();
+
+	/** World size of a tile whose points give the density (in meshes per 1000x1000 units) */
+	float GetTileSize(float Density) const;
+
+	/** Appends the world positions of the points inside the area. The tiles are aligned to the world grid */
+	void GetPoints(const FBox2D& Area, float TileSize, int32 Seed, TArray<FVector2D>& OutPoints) const;
+
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+
+private:
+	/** World positions of every point of a tile, after its variation, rotation and offset are applied */
+	void GetTilePoints(int32 TileX, int32 TileY, float TileSize, int32 Seed, TArray<FVector2D>& OutPoints) const;
+};
@@ -0,0 +1,19 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteBlueNoiseFactory.h"
+#include "HasteBlueNoise.h"
+
+UHasteBlueNoiseTilesFactory::UHasteBlueNoiseTilesFactory(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	SupportedClass = UHasteBlueNoiseTiles::StaticClass();
+	bCreateNew = true;
+	bEditAfterNew = true;
+}
+
+UObject* UHasteBlueNoiseTilesFactory::FactoryCreateNew(UClass* Class, UObject* InParent, FName Name, EObjectFlags Flags, UObject* Context, FFeedbackContext* Warn)
+{
+	UHasteBlueNoiseTiles* Tiles = NewObject<UHasteBlueNoiseTiles>(InParent, Class, Name, Flags | RF_Transactional);
+	Tiles->Generate();
+	return Tiles;
+}
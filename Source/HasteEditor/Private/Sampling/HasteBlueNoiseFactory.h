@@ -0,0 +1,13 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "Factories/Factory.h"
+#include "HasteBlueNoiseFactory.generated.h"
+
+/** Creates Haste blue noise tile sets from the content browser */
+UCLASS()
+class UHasteBlueNoiseTilesFactory : public UFactory {
+	GENERATED_UCLASS_BODY()
+
+public:
+	virtual UObject* FactoryCreateNew(UClass* Class, UObject* InParent, FName Name, EObjectFlags Flags, UObject* Context, FFeedbackContext* Warn) override;
+};
@@ -0,0 +1,62 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#include "HasteEditorPrivatePCH.h"
+#include "HasteStamp.h"
+
+UHasteStamp::UHasteStamp(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, Bounds(ForceInitToZero)
+	, bCompiled(false)
+{
+}
+
+const TArray<FHasteStampMeshGroup>& UHasteStamp::GetMeshGroups()
+{
+	if (!bCompiled) {
+		Compile();
+	}
+	return MeshGroups;
+}
+
+const FBoxSphereBounds& UHasteStamp::GetBounds()
+{
+	if (!bCompiled) {
+		Compile();
+	}
+	return Bounds;
+}
+
+void UHasteStamp::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	bCompiled = false;
+}
+
+void UHasteStamp::PostEditUndo()
+{
+	Super::PostEditUndo();
+	bCompiled = false;
+}
+
+void UHasteStamp::Compile()
+{
+	MeshGroups.Reset();
+	TMap<UStaticMesh*, int32> GroupIndices;
+	FBox Box(0);
+
+	for (const FHasteStampEntry& Entry : Entries) {
+		if (!Entry.Mesh) continue;
+
+		int32* GroupIndex = GroupIndices.Find(Entry.Mesh);
+		if (!GroupIndex) {
+			FHasteStampMeshGroup Group;
+			Group.Mesh = Entry.Mesh;
+			GroupIndex = &GroupIndices.Add(Entry.Mesh, MeshGroups.Add(Group));
+		}
+		MeshGroups[*GroupIndex].RelativeTransforms.Add(Entry.RelativeTransform);
+
+		Box += Entry.Mesh->GetBounds().GetBox().TransformBy(Entry.RelativeTransform);
+	}
+
+	Bounds = Box.IsValid ? FBoxSphereBounds(Box) : FBoxSphereBounds(ForceInitToZero);
+	bCompiled = true;
+}
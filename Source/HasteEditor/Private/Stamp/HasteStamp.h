@@ -0,0 +1,60 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "HasteStamp.generated.h"
+
+/** A mesh within a stamp, relative to the stamp's root */
+USTRUCT()
+struct FHasteStampEntry
+{
+	GENERATED_USTRUCT_BODY()
+
+	FHasteStampEntry()
+		: Mesh(nullptr)
+		, RelativeTransform(FTransform::Identity)
+	{
+	}
+
+	UPROPERTY(EditAnywhere, Category = Stamp)
+	UStaticMesh* Mesh;
+
+	UPROPERTY(EditAnywhere, Category = Stamp)
+	FTransform RelativeTransform;
+};
+
+/** All the instances of one mesh within a stamp */
+struct FHasteStampMeshGroup
+{
+	UStaticMesh* Mesh;
+	TArray<FTransform> RelativeTransforms;
+};
+
+/**
+ * A group of meshes that is placed as a whole with a single click (e.g. a rock cluster with a bush and some debris).
+ * The entries are compiled into per-mesh instance lists, so placing a stamp is a transform multiply per instance
+ * and one batched add per mesh
+ */
+UCLASS(BlueprintType)
+class UHasteStamp : public UObject {
+	GENERATED_UCLASS_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = Stamp)
+	TArray<FHasteStampEntry> Entries;
+
+	/** The entries grouped by mesh */
+	const TArray<FHasteStampMeshGroup>& GetMeshGroups();
+
+	/** Bounds of the whole stamp, relative to its root */
+	const FBoxSphereBounds& GetBounds();
+
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
+
+private:
+	void Compile();
+
+private:
+	TArray<FHasteStampMeshGroup> MeshGroups;
+	FBoxSphereBounds Bounds;
+	bool bCompiled;
+};
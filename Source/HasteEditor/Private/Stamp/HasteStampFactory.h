@@ -0,0 +1,13 @@
+// Copyright 2015-2016 Code Respawn Technologies. MIT License
+#pragma once
+#include "Factories/Factory.h"
+#include "HasteStampFactory.generated.h"
+
+/** Creates Haste stamp assets from the content browser */
+UCLASS()
+class UHasteStampFactory : public UFactory {
+	GENERATED_UCLASS_BODY()
+
+public:
+	virtual UObject* FactoryCreateNew(UClass* Class, UObject* InParent, FName Name, EObjectFlags Flags, UObject* Context, FFeedbackContext* Warn) override;
+};
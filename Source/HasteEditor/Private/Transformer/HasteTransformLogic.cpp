@@ -1,9 +1,81 @@
 // Copyright 2015-2016 Code Respawn Technologies. MIT License
 #include "HasteEditorPrivatePCH.h"
 #include "HasteTransformLogic.h"
+#include "ParallelFor.h"
 
+/** Fixed chunk size, so the random stream used for each transform does not depend on the number of worker threads */
+#define HASTE_TRANSFORM_CHUNK_SIZE 256
 
 void UHasteTransformLogic::TransformObject_Implementation(const FTransform& CurrentTransform, FTransform& Offset)
 {
 	Offset = FTransform::Identity;
 }
+
+void UHasteTransformLogic::TransformObjectThreadSafe(const FTransform& CurrentTransform, FRandomStream& Random, FTransform& Offset) const
+{
+	Offset = FTransform::Identity;
+}
+
+bool UHasteTransformLogic::RunsOnWorkerThreads() const
+{
+	return IsThreadSafe() && GetClass()->HasAnyClassFlags(CLASS_Native);
+}
+
+bool UHasteTransformLogic::AreThreadSafe(const TArray<UHasteTransformLogic*>& Transformers)
+{
+	for (const UHasteTransformLogic* TransformLogic : Transformers) {
+		if (TransformLogic && !TransformLogic->RunsOnWorkerThreads()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void UHasteTransformLogic::ApplyTransformers(const TArray<UHasteTransformLogic*>& Transformers, TArray<FTransform>& Transforms, int32 Seed)
+{
+	// Split the stack into runs of thread safe and game thread transformers, keeping their order
+	int32 RunStart = 0;
+	while (RunStart < Transformers.Num()) {
+		if (!Transformers[RunStart]) {
+			RunStart++;
+			continue;
+		}
+
+		const bool bThreadSafe = Transformers[RunStart]->RunsOnWorkerThreads();
+		int32 RunEnd = RunStart + 1;
+		while (RunEnd < Transformers.Num() && (!Transformers[RunEnd] || Transformers[RunEnd]->RunsOnWorkerThreads() == bThreadSafe)) {
+			RunEnd++;
+		}
+
+		if (bThreadSafe) {
+			const int32 NumChunks = FMath::DivideAndRoundUp(Transforms.Num(), HASTE_TRANSFORM_CHUNK_SIZE);
+			ParallelFor(NumChunks, [&](int32 ChunkIndex) {
+				FRandomStream Random(HashCombine(HashCombine(uint32(Seed), uint32(RunStart)), uint32(ChunkIndex)));
+				const int32 ChunkEnd = FMath::Min((ChunkIndex + 1) * HASTE_TRANSFORM_CHUNK_SIZE, Transforms.Num());
+				for (int32 Index = ChunkIndex * HASTE_TRANSFORM_CHUNK_SIZE; Index < ChunkEnd; Index++) {
+					FTransform& Transform = Transforms[Index];
+					for (int32 TransformerIndex = RunStart; TransformerIndex < RunEnd; TransformerIndex++) {
+						const UHasteTransformLogic* TransformLogic = Transformers[TransformerIndex];
+						if (!TransformLogic) continue;
+						FTransform Offset;
+						TransformLogic->TransformObjectThreadSafe(Transform, Random, Offset);
+						Transform = Offset * Transform;
+					}
+				}
+			});
+		}
+		else {
+			for (FTransform& Transform : Transforms) {
+				for (int32 TransformerIndex = RunStart; TransformerIndex < RunEnd; TransformerIndex++) {
+					UHasteTransformLogic* TransformLogic = Transformers[TransformerIndex];
+					if (!TransformLogic) continue;
+					FTransform Offset;
+					TransformLogic->TransformObject(Transform, Offset);
+					Transform = Offset * Transform;
+				}
+			}
+		}
+
+		RunStart = RunEnd;
+	}
+}
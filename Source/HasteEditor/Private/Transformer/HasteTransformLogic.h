@@ -12,4 +12,29 @@ public:
 	void TransformObject(const FTransform& CurrentTransform, FTransform& Offset);
 	virtual void TransformObject_Implementation(const FTransform& CurrentTransform, FTransform& Offset);
 
+	/**
+	 * Return true if TransformObjectThreadSafe can run on worker threads. The logic has to be native,
+	 * must not modify any UObject and may only draw random numbers from the stream it is given
+	 */
+	virtual bool IsThreadSafe() const { return false; }
+
+	/** Thread safe variant of TransformObject, used when IsThreadSafe returns true */
+	virtual void TransformObjectThreadSafe(const FTransform& CurrentTransform, FRandomStream& Random, FTransform& Offset) const;
+
+	/**
+	 * Runs the transformer stack over the transforms.
+	 * Consecutive thread safe transformers are evaluated in parallel chunks, each with its own random stream derived
+	 * from the seed, so the results do not depend on the number of threads. Other transformers run on the game thread
+	 */
+	static void ApplyTransformers(const TArray<UHasteTransformLogic*>& Transformers, TArray<FTransform>& Transforms, int32 Seed);
+
+	/** Returns true if the whole stack can be applied from a worker thread */
+	static bool AreThreadSafe(const TArray<UHasteTransformLogic*>& Transformers);
+
+private:
+	/**
+	 * Returns true if the transformer runs through TransformObjectThreadSafe. Blueprint subclasses of a thread safe
+	 * transformer may override TransformObject, so they always run on the game thread
+	 */
+	bool RunsOnWorkerThreads() const;
 };
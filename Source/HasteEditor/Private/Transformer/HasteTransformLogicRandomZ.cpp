@@ -8,3 +8,10 @@ void UHasteTransformLogicRandomZ::TransformObject_Implementation(const FTransfor
 	Offset = FTransform::Identity;
 	Offset.SetRotation(Rotation);
 }
+
+void UHasteTransformLogicRandomZ::TransformObjectThreadSafe(const FTransform& CurrentTransform, FRandomStream& Random, FTransform& Offset) const
+{
+	FQuat Rotation = FQuat::MakeFromEuler(FVector(0, 0, Random.FRandRange(0, 360)));
+	Offset = FTransform::Identity;
+	Offset.SetRotation(Rotation);
+}
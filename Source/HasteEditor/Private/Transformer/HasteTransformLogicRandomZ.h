@@ -9,4 +9,6 @@ class UHasteTransformLogicRandomZ : public UHasteTransformLogic
 
 public:
 	virtual void TransformObject_Implementation(const FTransform& CurrentTransform, FTransform& Offset) override;
+	virtual bool IsThreadSafe() const override { return true; }
+	virtual void TransformObjectThreadSafe(const FTransform& CurrentTransform, FRandomStream& Random, FTransform& Offset) const override;
 };